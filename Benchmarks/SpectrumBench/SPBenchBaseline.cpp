@@ -0,0 +1,197 @@
+#include "SPBenchBaseline.h"
+
+#include <QSysInfo>
+#include <QThread>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QHash>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <algorithm>
+#include <cmath>
+
+
+static QList<double> samplesOf(const QJsonObject& scenario) {
+    QList<double> samples{};
+    for (const QJsonValue& value : scenario.value("samples").toArray()) samples.append(value.toDouble());
+    return samples;
+}
+
+static QHash<QString, QJsonObject> scenariosOf(const QJsonObject& results) {
+    QHash<QString, QJsonObject> scenarios{};
+    for (const QJsonValue& value : results.value("scenarios").toArray()) {
+        QJsonObject scenario = value.toObject();
+        scenarios.insert(scenario.value("name").toString(), scenario);
+    }
+    return scenarios;
+}
+
+
+QString SPBenchBaseline::machineFingerprint() {
+    QByteArray key = QJsonDocument(machineInfo()).toJson(QJsonDocument::Compact);
+    return QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex().left(12);
+}
+
+QJsonObject SPBenchBaseline::machineInfo() {
+    return QJsonObject{
+        { "cpu", QSysInfo::currentCpuArchitecture() },
+        { "os", QSysInfo::prettyProductName() },
+        { "kernel", QSysInfo::kernelVersion() },
+        { "host", QSysInfo::machineHostName() },
+        { "threads", QThread::idealThreadCount() },
+        { "qt", QString(qVersion()) },
+    };
+}
+
+QString SPBenchBaseline::baselinePath(const QString& directory) {
+    return QDir(directory).filePath(machineFingerprint() + ".json");
+}
+
+QJsonObject SPBenchBaseline::load(const QString& path, QString* error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = "لا يمكن قراءة " + path;
+        return {};
+    }
+
+    QJsonParseError parseError{};
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject()) {
+        if (error) *error = path + ": " + parseError.errorString();
+        return {};
+    }
+    return document.object();
+}
+
+bool SPBenchBaseline::save(const QString& path, const QJsonObject& results) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    return file.write(QJsonDocument(results).toJson(QJsonDocument::Indented)) > 0;
+}
+
+QList<SPBenchBaseline::Comparison> SPBenchBaseline::compare(const QJsonObject& baseline, const QJsonObject& current,
+                                                            double tolerancePercent, double alpha) {
+    QHash<QString, QJsonObject> baseScenarios = scenariosOf(baseline);
+    QList<Comparison> comparisons{};
+
+    for (const QJsonValue& value : current.value("scenarios").toArray()) {
+        QJsonObject scenario = value.toObject();
+        Comparison comparison{
+            .name = scenario.value("name").toString(),
+            .currentMedian = scenario.value("median").toDouble(),
+        };
+
+        auto base = baseScenarios.constFind(comparison.name);
+        if (base == baseScenarios.cend()) {
+            comparison.verdict = Missing;
+            comparisons.append(comparison);
+            continue;
+        }
+
+        comparison.baselineMedian = base->value("median").toDouble();
+        if (comparison.baselineMedian > 0) {
+            comparison.changePercent = 100.0 * (comparison.currentMedian - comparison.baselineMedian)
+                                     / comparison.baselineMedian;
+        }
+        comparison.pValue = mannWhitneyP(samplesOf(*base), samplesOf(scenario));
+
+        // الفرق الدال إحصائياً والصغير لا يعد تغيراً، وكذلك الكبير الذي قد يكون ضجيجاً
+        bool significant = comparison.pValue < alpha;
+        if (significant and comparison.changePercent > tolerancePercent) comparison.verdict = Regression;
+        else if (significant and comparison.changePercent < -tolerancePercent) comparison.verdict = Improvement;
+        comparisons.append(comparison);
+    }
+    return comparisons;
+}
+
+double SPBenchBaseline::mannWhitneyP(const QList<double>& first, const QList<double>& second) {
+    const qsizetype n1 = first.size();
+    const qsizetype n2 = second.size();
+    if (n1 < 2 or n2 < 2) return 1;
+
+    // ترتيب العينتين معاً، والقيم المتساوية تأخذ متوسط رتبها
+    QList<std::pair<double, bool>> values{};
+    for (double value : first) values.append({ value, true });
+    for (double value : second) values.append({ value, false });
+    std::sort(values.begin(), values.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    const qsizetype n = values.size();
+    double firstRanks = 0;
+    double ties = 0;
+    for (qsizetype i = 0; i < n;) {
+        qsizetype j = i;
+        while (j < n and values.at(j).first == values.at(i).first) ++j;
+        double rank = (i + 1 + j) / 2.0;
+        for (qsizetype k = i; k < j; ++k) {
+            if (values.at(k).second) firstRanks += rank;
+        }
+        double count = double(j - i);
+        ties += count * count * count - count;
+        i = j;
+    }
+
+    double u = firstRanks - n1 * (n1 + 1) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1) - ties / (double(n) * (n - 1)));
+    if (variance <= 0) return 1;
+
+    // تصحيح الاستمرارية نصف وحدة نحو المتوسط
+    double distance = qMax(0.0, std::abs(u - mean) - 0.5);
+    double z = distance / std::sqrt(variance);
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+QString SPBenchBaseline::report(const QList<Comparison>& comparisons, const QJsonObject& baseline,
+                                const QJsonObject& current, double tolerancePercent) {
+    QString text{};
+    text += QString("خط الأساس: %1، النتيجة الحالية: %2، السماحية: %3%\n")
+                .arg(baseline.value("label").toString("-"), current.value("label").toString("-"))
+                .arg(tolerancePercent, 0, 'f', 1);
+
+    QString baseMachine = baseline.value("machine").toObject().value("fingerprint").toString();
+    QString currentMachine = current.value("machine").toObject().value("fingerprint").toString();
+    if (baseMachine != currentMachine) {
+        text += QString("تنبيه: خط الأساس من جهاز آخر (%1 وليس %2)\n").arg(baseMachine, currentMachine);
+    }
+    if (baseline.value("lines").toInt() != current.value("lines").toInt()) {
+        text += QString("تنبيه: حجم النص مختلف (%1 سطر وليس %2)\n")
+                    .arg(baseline.value("lines").toInt()).arg(current.value("lines").toInt());
+    }
+
+    text += "الحالة | الأساس (مللي ثانية) | الحالي | التغير | p | النتيجة\n";
+    for (const Comparison& comparison : comparisons) {
+        QString verdict{};
+        switch (comparison.verdict) {
+        case Unchanged: verdict = "بدون تغير"; break;
+        case Regression: verdict = "تراجع"; break;
+        case Improvement: verdict = "تحسن"; break;
+        case Missing: verdict = "غير موجودة في الأساس"; break;
+        }
+
+        if (comparison.verdict == Missing) {
+            text += QString("%1 | - | %2 | - | - | %3\n")
+                        .arg(comparison.name)
+                        .arg(comparison.currentMedian, 0, 'f', 3)
+                        .arg(verdict);
+            continue;
+        }
+        text += QString("%1 | %2 | %3 | %4% | %5 | %6\n")
+                    .arg(comparison.name)
+                    .arg(comparison.baselineMedian, 0, 'f', 3)
+                    .arg(comparison.currentMedian, 0, 'f', 3)
+                    .arg(comparison.changePercent, 0, 'f', 1)
+                    .arg(comparison.pValue, 0, 'f', 4)
+                    .arg(verdict);
+    }
+    return text;
+}
+
+bool SPBenchBaseline::hasRegression(const QList<Comparison>& comparisons) {
+    return std::any_of(comparisons.cbegin(), comparisons.cend(),
+                       [](const Comparison& comparison) { return comparison.verdict == Regression; });
+}
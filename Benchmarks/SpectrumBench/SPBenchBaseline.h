@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QJsonObject>
+
+
+// مقارنة نتائج القياس بخط أساس محفوظ لنفس الجهاز
+// النتائج بنفس صيغة JSON التي يكتبها spectrum-bench، فتقارن نتيجة تشغيل جديد أو ملفان محفوظان بنفس الطريقة
+// الفرق يعد تراجعاً إذا كان اختبار Mann–Whitney دالاً وتغير الوسيط أكبر من السماحية
+class SPBenchBaseline {
+public:
+    enum Verdict {
+        Unchanged,
+        Regression,
+        Improvement,
+        Missing         // الحالة غير موجودة في خط الأساس
+    };
+
+    struct Comparison {
+        QString name{};
+        double baselineMedian{};
+        double currentMedian{};
+        double changePercent{};
+        double pValue{ 1 };
+        Verdict verdict{};
+    };
+
+    // بصمة الجهاز: المعالج ونظام التشغيل وعدد الخيوط ونسخة Qt، فلا يقارن جهاز بآخر
+    static QString machineFingerprint();
+    static QJsonObject machineInfo();
+    static QString baselinePath(const QString& directory);
+
+    static QJsonObject load(const QString& path, QString* error = nullptr);
+    static bool save(const QString& path, const QJsonObject& results);
+
+    static QList<Comparison> compare(const QJsonObject& baseline, const QJsonObject& current,
+                                     double tolerancePercent, double alpha);
+    // اختبار Mann–Whitney ذو الطرفين بالتقريب الطبيعي مع تصحيح التساوي، ويرجع قيمة p
+    static double mannWhitneyP(const QList<double>& first, const QList<double>& second);
+
+    static QString report(const QList<Comparison>& comparisons, const QJsonObject& baseline,
+                          const QJsonObject& current, double tolerancePercent);
+    static bool hasRegression(const QList<Comparison>& comparisons);
+};
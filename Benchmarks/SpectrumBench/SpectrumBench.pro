@@ -0,0 +1,19 @@
+QT += core gui widgets concurrent network
+
+CONFIG += c++23 console
+CONFIG -= app_bundle
+
+TARGET = spectrum-bench
+
+RESOURCES += \
+    ../../Spectrum/resources.qrc
+
+# نفس ملفات المحرر التي يبنى منها البرنامج
+include(../../Source/Source.pri)
+
+SOURCES += \
+    main.cpp    \
+    SPBenchBaseline.cpp \
+
+HEADERS += \
+    SPBenchBaseline.h   \
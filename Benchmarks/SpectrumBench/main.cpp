@@ -0,0 +1,396 @@
+#include "SPEditor.h"
+#include "SPHighlighter.h"
+#include "AlifLexer.h"
+#include "SPFileCache.h"
+#include "SPConfig.h"
+#include "SPTheme.h"
+#include "SPFonts.h"
+#include "SPBenchBaseline.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QStandardPaths>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QStringDecoder>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QScrollBar>
+#include <QTextStream>
+#include <QFile>
+#include <QDebug>
+
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+
+// يقيس أعمال المحرر الأساسية دون نافذة ظاهرة وبنص مولد بنفس البذرة في كل تشغيل
+// فتكون الأرقام قابلة للمقارنة بين نسخة وأخرى
+// التشغيل: spectrum-bench [--lines N] [--warmup W] [--reps R] [--filter اسم] [--label نسخة] [--json ملف|-]
+// المقارنة قبل الدمج: spectrum-bench --save-baseline على الفرع الأساسي، ثم spectrum-bench --compare على التغيير
+
+
+struct Scenario {
+    QString name{};
+    std::function<void()> setup{};  // يسبق كل تكرار ولا يدخل في القياس
+    std::function<void()> run{};
+};
+
+struct Result {
+    QString name{};
+    QList<double> samples{};
+    double min{};
+    double median{};
+    double mean{};
+    double stddev{};
+    double max{};
+};
+
+
+static constexpr quint32 corpusSeed = 20240601;
+
+// نص ألف مولد: دوال وشروط وحلقات وتعليقات ونصوص وأرقام بنسب ثابتة
+static QString generateCorpus(int lineCount) {
+    QRandomGenerator random(corpusSeed);
+    static const QStringList names = { "س", "ص", "عدد", "مجموع", "قائمة", "نتيجة", "عنصر", "طول" };
+    auto name = [&]() { return names.at(random.bounded(int(names.size()))) + QString::number(random.bounded(100)); };
+
+    QString text{};
+    int lines = 0;
+    while (lines < lineCount) {
+        text += QString("دالة %1(%2، %3):\n").arg(name(), name(), name());
+        text += QString("    # تعليق رقم %1\n").arg(lines);
+        text += QString("    %1 = %2 + %3 * %4\n").arg(name(), name()).arg(random.bounded(1000)).arg(random.bounded(3.14), 0, 'f', 2);
+        text += QString("    اذا %1 > %2:\n").arg(name()).arg(random.bounded(50));
+        text += QString("        اطبع(\"القيمة %1\")\n").arg(random.bounded(10000));
+        text += QString("    لاجل %1 في مدى(%2):\n").arg(name()).arg(random.bounded(20));
+        text += QString("        %1 = %1 + 1\n").arg(name());
+        text += QString("    ارجع %1\n\n").arg(name());
+        lines += 9;
+    }
+    return text;
+}
+
+static Result summarize(const QString& name, QList<double> samples) {
+    Result result{ .name = name, .samples = samples };
+    std::sort(samples.begin(), samples.end());
+    qsizetype count = samples.size();
+    result.min = samples.first();
+    result.max = samples.last();
+    result.median = count % 2 ? samples.at(count / 2)
+                              : (samples.at(count / 2 - 1) + samples.at(count / 2)) / 2;
+
+    double sum = 0;
+    for (double sample : samples) sum += sample;
+    result.mean = sum / count;
+
+    double squares = 0;
+    for (double sample : samples) squares += (sample - result.mean) * (sample - result.mean);
+    result.stddev = count > 1 ? std::sqrt(squares / (count - 1)) : 0;
+
+    return result;
+}
+
+static Result measure(const Scenario& scenario, int warmup, int repetitions) {
+    QElapsedTimer timer{};
+    QList<double> samples{};
+
+    for (int i = 0; i < warmup + repetitions; ++i) {
+        if (scenario.setup) scenario.setup();
+        QCoreApplication::processEvents();
+
+        timer.start();
+        scenario.run();
+        double elapsed = timer.nsecsElapsed() / 1e6;
+
+        if (i >= warmup) samples.append(elapsed);
+    }
+
+    return summarize(scenario.name, samples);
+}
+
+// شريط أرقام الأسطر لا يحمل Q_OBJECT، فيبحث عنه بين أبناء المحرر المباشرين
+static QWidget* lineNumberArea(SPEditor* editor) {
+    for (QWidget* child : editor->findChildren<QWidget*>(Qt::FindDirectChildrenOnly)) {
+        if (dynamic_cast<LineNumberArea*>(child)) return child;
+    }
+    return nullptr;
+}
+
+struct Options {
+    int lines{};
+    int warmup{};
+    int repetitions{};
+    QString filter{};
+    QString label{};
+};
+
+// يشغل الحالات ويطبع جدولها، ويرجع النتائج بصيغة JSON أو كائناً فارغاً إن تعذر التشغيل
+static QJsonObject runScenarios(const Options& options, QTextStream& table) {
+    const int lineCount = options.lines;
+    const int warmup = options.warmup;
+    const int repetitions = options.repetitions;
+
+    SPFonts::registerInBackground();
+    QStringList fontFamilies = SPFonts::families();
+    if (!fontFamilies.isEmpty()) {
+        QFont font{};
+        font.setFamilies(fontFamilies);
+        font.setPixelSize(16);
+        font.setWeight(QFont::Weight::Thin);
+        QApplication::setFont(font);
+    }
+    SPTheme::instance().apply(SPTheme::themeNames().first());
+
+    QString corpus = generateCorpus(lineCount);
+    QTemporaryDir directory{};
+    QString filePath = directory.filePath("bench.alif");
+    {
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qWarning() << "لا يمكن كتابة ملف القياس" << filePath;
+            return {};
+        }
+        file.write(corpus.toUtf8());
+    }
+
+    SPEditor editor{};
+    editor.resize(900, 1000);
+    editor.show();
+    editor.document()->setPlainText(corpus);
+    editor.warmUp();
+    QCoreApplication::processEvents();
+
+    QTextDocument highlightDocument{};
+    SyntaxHighlighter* highlighter{};
+
+    // نص اللصق نصف حجم الملف حتى يبقى زمنه قريباً من بقية الحالات
+    QString pasteText = corpus.left(corpus.size() / 2);
+
+    QList<Scenario> scenarios = {
+        { "lexing", {}, [&]() {
+            Lexer lexer{};
+            lexer.tokenize(corpus);
+        } },
+        { "highlighting", [&]() {
+            delete highlighter;
+            highlighter = nullptr;
+            highlightDocument.setPlainText(corpus);
+        }, [&]() {
+            highlighter = new SyntaxHighlighter(&highlightDocument);
+            highlighter->rehighlight();
+        } },
+        { "completion", [&]() {
+            editor.document()->setPlainText("\n");
+        }, [&]() {
+            // كل حرف يكتب يطلب قائمة الإكمال كما يحدث أثناء الكتابة
+            QTextCursor cursor = editor.textCursor();
+            for (const QString& keyword : AutoComplete::keywords()) {
+                for (QChar letter : keyword) {
+                    cursor.insertText(letter);
+                    editor.setTextCursor(cursor);
+                }
+                cursor.insertText("\n");
+                editor.setTextCursor(cursor);
+            }
+            QCoreApplication::processEvents();
+        } },
+        { "file-open", [&]() {
+            SPFileCache::instance().invalidate(filePath);
+        }, [&]() {
+            SPFileBufferPtr buffer = SPFileCache::instance().read(filePath);
+            if (!buffer) return;
+            QStringDecoder decoder(QStringDecoder::Utf8);
+            QString content = decoder(buffer->view());
+            content.replace("\r\n", "\n");
+            editor.document()->setPlainText(content);
+            editor.viewport()->grab();
+        } },
+        { "file-save", [&]() {
+            if (editor.document()->characterCount() < corpus.size()) editor.document()->setPlainText(corpus);
+        }, [&]() {
+            QString content = editor.document()->toPlainText();
+            QFile file(filePath);
+            if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+                QTextStream out(&file);
+                out << content;
+            }
+        } },
+        { "gutter-paint", [&]() {
+            if (editor.document()->characterCount() < corpus.size()) editor.document()->setPlainText(corpus);
+            editor.verticalScrollBar()->setValue(editor.verticalScrollBar()->maximum() / 2);
+        }, [&]() {
+            if (QWidget* gutter = lineNumberArea(&editor)) {
+                for (int i = 0; i < 50; ++i) gutter->grab();
+            }
+        } },
+        { "scrolling", [&]() {
+            if (editor.document()->characterCount() < corpus.size()) editor.document()->setPlainText(corpus);
+            editor.verticalScrollBar()->setValue(0);
+        }, [&]() {
+            QScrollBar* bar = editor.verticalScrollBar();
+            for (int i = 0; i < 100; ++i) {
+                bar->setValue(bar->value() + bar->pageStep());
+                editor.viewport()->grab();
+            }
+        } },
+        { "large-paste", [&]() {
+            editor.document()->setPlainText("\n");
+        }, [&]() {
+            editor.insertPlainText(pasteText);
+            QCoreApplication::processEvents();
+        } },
+    };
+
+    table << QString("%1 سطر، %2 تكرار للتهيئة، %3 تكرار للقياس\n").arg(lineCount).arg(warmup).arg(repetitions);
+    table << "الحالة | الأدنى | الوسيط | المتوسط | الانحراف | الأعلى (مللي ثانية)\n";
+
+    QList<Result> results{};
+    for (const Scenario& scenario : scenarios) {
+        if (!options.filter.isEmpty() and !scenario.name.contains(options.filter)) continue;
+        Result result = measure(scenario, warmup, repetitions);
+        results.append(result);
+        table << QString("%1 | %2 | %3 | %4 | %5 | %6\n")
+                     .arg(result.name)
+                     .arg(result.min, 0, 'f', 3)
+                     .arg(result.median, 0, 'f', 3)
+                     .arg(result.mean, 0, 'f', 3)
+                     .arg(result.stddev, 0, 'f', 3)
+                     .arg(result.max, 0, 'f', 3);
+        table.flush();
+    }
+    delete highlighter;
+
+    QJsonArray scenarioArray{};
+    for (const Result& result : results) {
+        QJsonArray samples{};
+        for (double sample : result.samples) samples.append(sample);
+        scenarioArray.append(QJsonObject{
+            { "name", result.name },
+            { "unit", "ms" },
+            { "samples", samples },
+            { "min", result.min },
+            { "median", result.median },
+            { "mean", result.mean },
+            { "stddev", result.stddev },
+            { "max", result.max },
+        });
+    }
+
+    QJsonObject machine = SPBenchBaseline::machineInfo();
+    machine.insert("fingerprint", SPBenchBaseline::machineFingerprint());
+
+    return QJsonObject{
+        { "version", 1 },
+        { "label", options.label },
+        { "qt", QString(qVersion()) },
+        { "machine", machine },
+        { "lines", lineCount },
+        { "warmup", warmup },
+        { "repetitions", repetitions },
+        { "scenarios", scenarioArray },
+    };
+}
+
+static bool writeJson(const QJsonObject& results, const QString& path) {
+    QByteArray json = QJsonDocument(results).toJson(QJsonDocument::Indented);
+    QFile file(path == "-" ? QString() : path);
+    bool opened = path == "-" ? file.open(stdout, QIODevice::WriteOnly) : file.open(QIODevice::WriteOnly);
+    return opened and file.write(json) == json.size();
+}
+
+int main(int argc, char* argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    // لا تقرأ إعدادات المستخدم ولا تكتب فيها
+    QStandardPaths::setTestModeEnabled(true);
+    SPConfig::instance();
+
+    QApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("Alif");
+    QCoreApplication::setApplicationName("spectrum-bench");
+    app.setLayoutDirection(Qt::RightToLeft);
+
+    QCommandLineParser parser{};
+    parser.addHelpOption();
+    QCommandLineOption linesOption("lines", "عدد أسطر النص المولد", "N", "20000");
+    QCommandLineOption warmupOption("warmup", "تكرارات تسبق القياس", "W", "2");
+    QCommandLineOption repsOption("reps", "تكرارات القياس", "R", "10");
+    QCommandLineOption filterOption("filter", "تشغيل الحالات التي يحتوي اسمها النص فقط", "text");
+    QCommandLineOption labelOption("label", "اسم النسخة في ملف النتائج", "label");
+    QCommandLineOption jsonOption("json", "كتابة النتائج بصيغة JSON في ملف، أو - للمخرج القياسي", "path");
+    QCommandLineOption inputOption("input", "استخدام نتائج محفوظة بدل التشغيل", "path");
+    QCommandLineOption baselineDirOption("baseline-dir", "مجلد خطوط الأساس، وفيه ملف لكل بصمة جهاز", "dir", "bench-baselines");
+    QCommandLineOption baselineOption("baseline", "ملف خط أساس بدل ملف هذا الجهاز", "path");
+    QCommandLineOption saveOption("save-baseline", "حفظ النتائج خطَّ أساس لهذا الجهاز");
+    QCommandLineOption compareOption("compare", "مقارنة النتائج بخط الأساس، ورمز الخروج 2 عند وجود تراجع");
+    QCommandLineOption toleranceOption("tolerance", "أقل تغير في الوسيط يعد تراجعاً، بالنسبة المئوية", "percent", "5");
+    QCommandLineOption alphaOption("alpha", "مستوى الدلالة لاختبار Mann–Whitney", "p", "0.05");
+    parser.addOptions({ linesOption, warmupOption, repsOption, filterOption, labelOption, jsonOption,
+                        inputOption, baselineDirOption, baselineOption, saveOption, compareOption,
+                        toleranceOption, alphaOption });
+    parser.process(app);
+
+    Options options{
+        .lines = qMax(100, parser.value(linesOption).toInt()),
+        .warmup = qMax(0, parser.value(warmupOption).toInt()),
+        .repetitions = qMax(1, parser.value(repsOption).toInt()),
+        .filter = parser.value(filterOption),
+        .label = parser.value(labelOption),
+    };
+    QString jsonPath = parser.value(jsonOption);
+
+    // عند كتابة النتائج في المخرج القياسي يذهب الجدول والتقرير إلى مخرج الأخطاء
+    QTextStream table(jsonPath == "-" ? stderr : stdout);
+
+    QJsonObject results{};
+    if (parser.isSet(inputOption)) {
+        QString error{};
+        results = SPBenchBaseline::load(parser.value(inputOption), &error);
+        if (results.isEmpty()) {
+            table << error << "\n";
+            return 1;
+        }
+    }
+    else {
+        results = runScenarios(options, table);
+        if (results.isEmpty()) return 1;
+    }
+
+    if (!jsonPath.isEmpty() and !writeJson(results, jsonPath)) {
+        qWarning() << "لا يمكن كتابة ملف النتائج" << jsonPath;
+        return 1;
+    }
+
+    QString baselinePath = parser.isSet(baselineOption) ? parser.value(baselineOption)
+                                                        : SPBenchBaseline::baselinePath(parser.value(baselineDirOption));
+    int exitCode = 0;
+
+    // المقارنة تسبق الحفظ، فيمكن المقارنة بخط الأساس القديم ثم استبداله في نفس التشغيل
+    if (parser.isSet(compareOption)) {
+        QString error{};
+        QJsonObject baseline = SPBenchBaseline::load(baselinePath, &error);
+        if (baseline.isEmpty()) {
+            table << error << "\n";
+            return 1;
+        }
+
+        double tolerance = parser.value(toleranceOption).toDouble();
+        double alpha = parser.value(alphaOption).toDouble();
+        QList<SPBenchBaseline::Comparison> comparisons = SPBenchBaseline::compare(baseline, results, tolerance, alpha);
+        table << "\n" << SPBenchBaseline::report(comparisons, baseline, results, tolerance);
+        if (SPBenchBaseline::hasRegression(comparisons)) exitCode = 2;
+    }
+
+    if (parser.isSet(saveOption)) {
+        if (!SPBenchBaseline::save(baselinePath, results)) {
+            qWarning() << "لا يمكن حفظ خط الأساس" << baselinePath;
+            return 1;
+        }
+        table << "حفظ خط الأساس: " << baselinePath << "\n";
+    }
+
+    return exitCode;
+}
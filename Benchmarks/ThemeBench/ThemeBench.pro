@@ -0,0 +1,15 @@
+QT += core gui widgets concurrent network
+
+CONFIG += c++23 console
+CONFIG -= app_bundle
+
+TARGET = ThemeBench
+
+RESOURCES += \
+    ../../Spectrum/resources.qrc
+
+# ملفات السمة والإعدادات تعتمد على بقية المحرر، فتؤخذ من نفس القائمة
+include(../../Source/Source.pri)
+
+SOURCES += \
+    main.cpp    \
@@ -0,0 +1,175 @@
+#include "SPTheme.h"
+
+#include <QApplication>
+#include <QMainWindow>
+#include <QDockWidget>
+#include <QPlainTextEdit>
+#include <QTreeWidget>
+#include <QLineEdit>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+
+// يقيس كلفة إنشاء النوافذ وإعادة رسمها وتبديل الألوان بطريقتين:
+// أوراق الأنماط كما كانت في المحرر، ولوحة الألوان مع نمط البرنامج
+// التشغيل: ThemeBench [عدد النوافذ] [مرات الرسم]، ويفضل مع QT_QPA_PLATFORM=offscreen
+
+
+static const char* appStyle = R"(
+    QScrollBar:vertical { background: transparent; width: 20px; margin: 18px 6px 18px 6px; }
+    QScrollBar::handle:vertical { background: #254663; min-height: 15px; border-radius: 4px; }
+    QScrollBar::handle:vertical:hover { background: #325573; }
+    QScrollBar::add-line:vertical { background: transparent; height: 16px; subcontrol-position: bottom; subcontrol-origin: margin; }
+    QScrollBar::sub-line:vertical { background: transparent; height: 16px; subcontrol-position: top; subcontrol-origin: margin; }
+    QScrollBar::up-arrow:vertical { width: 12px; image: url(:/icons/Resources/up-arrow.png); }
+    QScrollBar::down-arrow:vertical { width: 12px; image: url(:/icons/Resources/down-arrow.png); }
+    QScrollBar::add-page:vertical, QScrollBar::sub-page:vertical { background: none; }
+)";
+
+static const char* windowStyle = R"(
+    QMainWindow::separator { background-color: #2a2c44; width: 4px; height: 4px; }
+    QMainWindow::separator:hover { background-color: #393c5d; }
+)";
+
+static const char* dockStyle = R"(
+    QDockWidget { color: #dddddd; border: none; titlebar-close-icon: url(:/icons/Resources/close.png); }
+    QDockWidget::title { background-color: #1e202e; border: none; padding: 3px 5px 0 0; }
+    QDockWidget::close-button { icon-size: 10px; }
+)";
+
+static const char* panelStyle = R"(
+    QWidget { color: #dddddd; background-color: #141520; }
+    QLineEdit { border: 1px solid #303349; border-radius: 3px; padding: 4px; }
+    QTreeWidget { border: none; }
+)";
+
+static const char* editorStyle = "QPlainTextEdit { background-color: #141520; color: #cccccc; }";
+static const char* labelStyle = "color: #888; margin-bottom: 20px;";
+
+
+struct Result {
+    QString mode{};
+    double createMs{};
+    double repaintUs{};
+    double switchMs{};
+};
+
+static QMainWindow* createWindow(bool styleSheets) {
+    QMainWindow* window = new QMainWindow();
+    window->resize(800, 600);
+
+    QPlainTextEdit* editor = new QPlainTextEdit(window);
+    QString text{};
+    for (int i = 0; i < 200; ++i) {
+        text += QString("دالة اختبار_%1(س، ص):\n    ارجع س + ص\n").arg(i);
+    }
+    editor->setPlainText(text);
+    window->setCentralWidget(editor);
+
+    QDockWidget* dock = new QDockWidget("الملفات", window);
+    QWidget* content = new QWidget(dock);
+    QVBoxLayout* layout = new QVBoxLayout(content);
+    QLineEdit* input = new QLineEdit(content);
+    QLabel* label = new QLabel("نتائج البحث", content);
+    QTreeWidget* tree = new QTreeWidget(content);
+    tree->setHeaderHidden(true);
+    for (int i = 0; i < 50; ++i) {
+        new QTreeWidgetItem(tree, { QString("ملف_%1.alif").arg(i) });
+    }
+    layout->addWidget(input);
+    layout->addWidget(label);
+    layout->addWidget(tree);
+    dock->setWidget(content);
+    window->addDockWidget(Qt::RightDockWidgetArea, dock);
+
+    if (styleSheets) {
+        window->setStyleSheet(windowStyle);
+        editor->setStyleSheet(editorStyle);
+        dock->setStyleSheet(dockStyle);
+        content->setStyleSheet(panelStyle);
+        label->setStyleSheet(labelStyle);
+    }
+    else {
+        content->setBackgroundRole(QPalette::Base);
+        content->setAutoFillBackground(true);
+        tree->setFrameShape(QFrame::NoFrame);
+        label->setForegroundRole(QPalette::PlaceholderText);
+        label->setContentsMargins(0, 0, 0, 20);
+    }
+
+    return window;
+}
+
+static Result measure(const QString& mode, bool styleSheets, int windowCount, int repaintCount) {
+    Result result{ .mode = mode };
+    QElapsedTimer timer{};
+    QList<QMainWindow*> windows{};
+
+    timer.start();
+    for (int i = 0; i < windowCount; ++i) {
+        QMainWindow* window = createWindow(styleSheets);
+        window->ensurePolished();
+        windows.append(window);
+    }
+    result.createMs = timer.nsecsElapsed() / 1e6;
+
+    // الرسم الأول يفعل التخطيط، فلا يدخل في القياس
+    for (QMainWindow* window : windows) window->grab();
+
+    timer.restart();
+    for (int i = 0; i < repaintCount; ++i) {
+        for (QMainWindow* window : windows) window->grab();
+    }
+    result.repaintUs = timer.nsecsElapsed() / 1e3 / (qint64(repaintCount) * windowCount);
+
+    // تبديل الألوان ثم رسم كل النوافذ مرة واحدة
+    timer.restart();
+    if (styleSheets) {
+        for (QMainWindow* window : windows) {
+            for (QWidget* widget : window->findChildren<QWidget*>()) {
+                QString style = widget->styleSheet();
+                if (!style.isEmpty()) widget->setStyleSheet(style.replace("#141520", "#ffffff"));
+            }
+        }
+    }
+    else {
+        SPTheme::instance().apply(SPTheme::themeNames().last());
+    }
+    QCoreApplication::processEvents();
+    for (QMainWindow* window : windows) window->grab();
+    result.switchMs = timer.nsecsElapsed() / 1e6;
+
+    qDeleteAll(windows);
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    QApplication app(argc, argv);
+    app.setLayoutDirection(Qt::RightToLeft);
+
+    QStringList arguments = app.arguments();
+    int windowCount = qMax(1, arguments.value(1, "100").toInt());
+    int repaintCount = qMax(1, arguments.value(2, "20").toInt());
+
+    app.setStyleSheet(appStyle);
+    Result before = measure("أوراق الأنماط", true, windowCount, repaintCount);
+
+    app.setStyleSheet(QString());
+    SPTheme::instance().apply(SPTheme::themeNames().first());
+    Result after = measure("لوحة الألوان والنمط", false, windowCount, repaintCount);
+
+    QTextStream out(stdout);
+    out << QString("%1 نافذة، %2 مرة رسم لكل نافذة\n").arg(windowCount).arg(repaintCount);
+    out << "الطريقة | الإنشاء والتلميع (مللي ثانية) | الرسم لكل نافذة (ميكروثانية) | تبديل الألوان (مللي ثانية)\n";
+    for (const Result& result : { before, after }) {
+        out << QString("%1 | %2 | %3 | %4\n")
+                   .arg(result.mode)
+                   .arg(result.createMs, 0, 'f', 2)
+                   .arg(result.repaintUs, 0, 'f', 1)
+                   .arg(result.switchMs, 0, 'f', 2);
+    }
+
+    return 0;
+}
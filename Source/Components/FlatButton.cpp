@@ -43,7 +43,7 @@ void SPFlatButton::paintEvent(QPaintEvent *event) {
                      rect().right(), rect().bottom());
 
     // Draw text with right alignment
-    painter.setPen(palette().color(QPalette::ButtonText));
+    painter.setPen(palette().color(foregroundRole()));
     QRect textRect = rect().adjusted(50, 0, -15, 0);
     painter.drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter, text());
 
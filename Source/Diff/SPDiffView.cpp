@@ -0,0 +1,271 @@
+#include "SPDiffView.h"
+#include "SPFileCache.h"
+
+#include <QGridLayout>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QElapsedTimer>
+#include <QStringDecoder>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+
+SPDiffView::SPDiffView(QWidget* parent)
+    : QDockWidget(parent) {
+    setWindowTitle("مقارنة");
+    setFont(QFont("Tajawal"));
+    setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetClosable);
+
+    QWidget* content = new QWidget(this);
+    QGridLayout* layout = new QGridLayout(content);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(2);
+
+    oldTitleLabel = new QLabel(content);
+    newTitleLabel = new QLabel(content);
+    summaryLabel = new QLabel(content);
+    for (QLabel* label : { oldTitleLabel, newTitleLabel, summaryLabel }) {
+        label->setForegroundRole(QPalette::PlaceholderText);
+        label->setContentsMargins(6, 2, 6, 2);
+    }
+
+    oldEditor = new SPEditor(content);
+    newEditor = new SPEditor(content);
+    for (SPEditor* pane : { oldEditor, newEditor }) {
+        pane->setReadOnly(true);
+        // بدون التفاف يكون موضع شريط التمرير هو رقم السطر الأول الظاهر
+        pane->setLineWrapMode(QPlainTextEdit::NoWrap);
+    }
+
+    layout->addWidget(oldTitleLabel, 0, 0);
+    layout->addWidget(newTitleLabel, 0, 1);
+    layout->addWidget(oldEditor, 1, 0);
+    layout->addWidget(newEditor, 1, 1);
+    layout->addWidget(summaryLabel, 2, 0, 1, 2);
+    setWidget(content);
+
+    auto onScrolled = [this](SPEditor* from, SPEditor* to, bool fromOld) {
+        if (syncing) return;
+        syncing = true;
+        syncScroll(from, to, fromOld);
+        syncing = false;
+        updateDecorations(oldEditor, true);
+        updateDecorations(newEditor, false);
+    };
+    connect(oldEditor->verticalScrollBar(), &QScrollBar::valueChanged, this, [this, onScrolled]() {
+        onScrolled(oldEditor, newEditor, true);
+    });
+    connect(newEditor->verticalScrollBar(), &QScrollBar::valueChanged, this, [this, onScrolled]() {
+        onScrolled(newEditor, oldEditor, false);
+    });
+    connect(oldEditor->horizontalScrollBar(), &QScrollBar::valueChanged,
+            newEditor->horizontalScrollBar(), &QScrollBar::setValue);
+    connect(newEditor->horizontalScrollBar(), &QScrollBar::valueChanged,
+            oldEditor->horizontalScrollBar(), &QScrollBar::setValue);
+
+    diffWatcher = new QFutureWatcher<SPDiffResult>(this);
+    connect(diffWatcher, &QFutureWatcher<SPDiffResult>::finished, this, &SPDiffView::onDiffFinished);
+
+    connect(&SPTheme::instance(), &SPTheme::themeChanged, this, [this]() {
+        updateDecorations(oldEditor, true);
+        updateDecorations(newEditor, false);
+    });
+}
+
+SPDiffView::~SPDiffView() {
+    diffWatcher->waitForFinished();
+}
+
+void SPDiffView::compareFile(const QString& oldPath, const QString& oldTitle, const QString& newTitle, const QString& newText) {
+    oldTitleLabel->setText(oldTitle);
+    newTitleLabel->setText(newTitle);
+    startDiff(oldPath, QString(), newText);
+}
+
+void SPDiffView::compareTexts(const QString& oldTitle, const QString& oldText, const QString& newTitle, const QString& newText) {
+    oldTitleLabel->setText(oldTitle);
+    newTitleLabel->setText(newTitle);
+    startDiff(QString(), oldText, newText);
+}
+
+void SPDiffView::resizeEvent(QResizeEvent* event) {
+    QDockWidget::resizeEvent(event);
+    updateDecorations(oldEditor, true);
+    updateDecorations(newEditor, false);
+}
+
+void SPDiffView::startDiff(const QString& oldPath, const QString& oldText, const QString& newText) {
+    summaryLabel->setText("جاري المقارنة...");
+
+    // تعيين مستقبل جديد يلغي انتظار نتيجة أي مقارنة سابقة لم تنتهِ
+    diffWatcher->setFuture(QtConcurrent::run([oldPath, oldText, newText]() {
+        QElapsedTimer timer{};
+        timer.start();
+
+        SPDiffResult result{};
+        result.newText = newText;
+        if (oldPath.isEmpty()) {
+            result.oldText = oldText;
+        }
+        else {
+            SPFileBufferPtr buffer = SPFileCache::instance().read(oldPath);
+            if (!buffer) return result;
+            QStringDecoder decoder(QStringDecoder::Utf8);
+            result.oldText = decoder(buffer->view());
+        }
+        result.oldText.replace("\r\n", "\n");
+        result.newText.replace("\r\n", "\n");
+
+        result.hunks = SPLineDiff::diffText(result.oldText, result.newText);
+        result.elapsedMs = timer.elapsed();
+        result.ok = true;
+        return result;
+    }));
+}
+
+void SPDiffView::onDiffFinished() {
+    SPDiffResult result = diffWatcher->result();
+    if (!result.ok) {
+        summaryLabel->setText("تعذرت قراءة الملف");
+        return;
+    }
+
+    // التلوين القديم يشير إلى مواضع في النص السابق، فيزال قبل تغييره
+    hunks.clear();
+    refinements.clear();
+    oldEditor->setDiffSelections({});
+    newEditor->setDiffSelections({});
+
+    syncing = true;
+    oldEditor->setPlainText(result.oldText);
+    newEditor->setPlainText(result.newText);
+    syncing = false;
+    hunks = result.hunks;
+
+    int removedLines = 0;
+    int addedLines = 0;
+    for (const SPDiffHunk& hunk : std::as_const(hunks)) {
+        removedLines += hunk.oldCount;
+        addedLines += hunk.newCount;
+    }
+    if (hunks.isEmpty()) {
+        summaryLabel->setText(QString("لا توجد فروق (%1 مللي ثانية)").arg(result.elapsedMs));
+    }
+    else {
+        summaryLabel->setText(QString("%1 تغيير: +%2 -%3 (%4 مللي ثانية)")
+                                  .arg(hunks.size()).arg(addedLines).arg(removedLines).arg(result.elapsedMs));
+    }
+
+    // يبدأ العرض قبل أول تغيير بقليل، والتمرير يزامن الجهة الأخرى ويلون الأسطر الظاهرة
+    int firstLine = hunks.isEmpty() ? 0 : qMax(0, hunks.first().newStart - 3);
+    newEditor->verticalScrollBar()->setValue(firstLine);
+    updateDecorations(oldEditor, true);
+    updateDecorations(newEditor, false);
+}
+
+void SPDiffView::syncScroll(SPEditor* from, SPEditor* to, bool fromOld) {
+    to->verticalScrollBar()->setValue(mapLine(from->verticalScrollBar()->value(), fromOld));
+}
+
+// يحول رقم سطر في جهة إلى السطر المقابل له في الجهة الأخرى
+int SPDiffView::mapLine(int line, bool fromOld) const {
+    auto hunk = std::upper_bound(hunks.cbegin(), hunks.cend(), line, [fromOld](int value, const SPDiffHunk& item) {
+        return value < (fromOld ? item.oldStart : item.newStart);
+    });
+    if (hunk == hunks.cbegin()) return line;
+    --hunk;
+
+    int fromStart = fromOld ? hunk->oldStart : hunk->newStart;
+    int fromCount = fromOld ? hunk->oldCount : hunk->newCount;
+    int toStart = fromOld ? hunk->newStart : hunk->oldStart;
+    int toCount = fromOld ? hunk->newCount : hunk->oldCount;
+
+    if (line < fromStart + fromCount) {
+        return toStart + qMin(line - fromStart, qMax(toCount - 1, 0));
+    }
+    return toStart + toCount + (line - fromStart - fromCount);
+}
+
+void SPDiffView::updateDecorations(SPEditor* pane, bool isOld) {
+    if (hunks.isEmpty()) {
+        pane->setDiffSelections({});
+        return;
+    }
+
+    int first = pane->cursorForPosition(QPoint(0, 0)).blockNumber();
+    int last = pane->cursorForPosition(QPoint(0, pane->viewport()->height())).blockNumber();
+
+    auto startOf = [isOld](const SPDiffHunk& hunk) { return isOld ? hunk.oldStart : hunk.newStart; };
+    auto countOf = [isOld](const SPDiffHunk& hunk) { return isOld ? hunk.oldCount : hunk.newCount; };
+
+    const SPThemeColors& colors = SPTheme::instance().colors();
+    QColor lineColor = isOld ? colors.diffRemovedLine : colors.diffAddedLine;
+    QColor wordColor = isOld ? colors.diffRemovedWord : colors.diffAddedWord;
+    QTextDocument* document = pane->document();
+    QList<QTextEdit::ExtraSelection> selections{};
+
+    // أول جزء ينتهي بعد السطر الأول الظاهر، ثم الأجزاء التالية حتى آخر سطر ظاهر
+    auto hunk = std::partition_point(hunks.cbegin(), hunks.cend(), [&](const SPDiffHunk& item) {
+        return startOf(item) + countOf(item) <= first;
+    });
+    for (; hunk != hunks.cend() and startOf(*hunk) <= last; ++hunk) {
+        int hunkIndex = int(hunk - hunks.cbegin());
+        int from = qMax(first, startOf(*hunk));
+        int to = qMin(last, startOf(*hunk) + countOf(*hunk) - 1);
+
+        for (int line = from; line <= to; ++line) {
+            QTextBlock block = document->findBlockByNumber(line);
+            if (!block.isValid()) break;
+
+            QTextEdit::ExtraSelection selection{};
+            selection.format.setBackground(lineColor);
+            selection.format.setProperty(QTextFormat::FullWidthSelection, true);
+            selection.cursor = QTextCursor(block);
+            selections.append(selection);
+
+            // الأسطر المتقابلة في جزء معدل تقارن حرفاً بحرف
+            int offset = line - startOf(*hunk);
+            if (offset >= qMin(hunk->oldCount, hunk->newCount)) continue;
+
+            const LineRefinement& refined = refinement(hunkIndex, offset);
+            for (const QPair<int, int>& range : isOld ? refined.oldRanges : refined.newRanges) {
+                QTextEdit::ExtraSelection word{};
+                word.format.setBackground(wordColor);
+                word.cursor = QTextCursor(block);
+                word.cursor.setPosition(block.position() + range.first);
+                word.cursor.setPosition(block.position() + range.first + range.second, QTextCursor::KeepAnchor);
+                selections.append(word);
+            }
+        }
+    }
+
+    pane->setDiffSelections(selections);
+}
+
+const SPDiffView::LineRefinement& SPDiffView::refinement(int hunkIndex, int offset) {
+    qint64 key = (qint64(hunkIndex) << 32) | offset;
+    auto cached = refinements.constFind(key);
+    if (cached != refinements.constEnd()) return cached.value();
+
+    const SPDiffHunk& hunk = hunks.at(hunkIndex);
+    QString oldLine = oldEditor->document()->findBlockByNumber(hunk.oldStart + offset).text();
+    QString newLine = newEditor->document()->findBlockByNumber(hunk.newStart + offset).text();
+
+    // الأسطر الطويلة جداً تبقى ملونة كسطر كامل فقط
+    LineRefinement result{};
+    if (oldLine.size() <= maxRefineLength and newLine.size() <= maxRefineLength) {
+        QList<int> oldChars{};
+        QList<int> newChars{};
+        oldChars.reserve(oldLine.size());
+        newChars.reserve(newLine.size());
+        for (QChar ch : std::as_const(oldLine)) oldChars.append(ch.unicode());
+        for (QChar ch : std::as_const(newLine)) newChars.append(ch.unicode());
+
+        for (const SPDiffHunk& part : SPLineDiff::diff(oldChars, newChars)) {
+            if (part.oldCount > 0) result.oldRanges.append({ part.oldStart, part.oldCount });
+            if (part.newCount > 0) result.newRanges.append({ part.newStart, part.newCount });
+        }
+    }
+    return refinements.insert(key, result).value();
+}
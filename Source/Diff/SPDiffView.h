@@ -0,0 +1,66 @@
+#pragma once
+
+#include "SPLineDiff.h"
+#include "SPEditor.h"
+
+#include <QDockWidget>
+#include <QLabel>
+#include <QFutureWatcher>
+
+
+// نتيجة المقارنة كما تصل من الخيط الخلفي
+struct SPDiffResult {
+    bool ok{};
+    QString oldText{};
+    QString newText{};
+    QList<SPDiffHunk> hunks{};
+    qint64 elapsedMs{};
+};
+
+
+// عرض الفروق بين نصين جنباً إلى جنب في محررين للقراءة فقط مع تمرير متزامن
+// مقارنة الأسطر تتم في خيط خلفي، أما الفروق داخل السطر فتحسب فقط للأسطر الظاهرة
+// عند التمرير وتحفظ حتى المقارنة التالية
+class SPDiffView : public QDockWidget {
+    Q_OBJECT
+
+public:
+    explicit SPDiffView(QWidget* parent = nullptr);
+    ~SPDiffView();
+
+    // الملف القديم يقرأ من القرص في الخيط الخلفي
+    void compareFile(const QString& oldPath, const QString& oldTitle, const QString& newTitle, const QString& newText);
+    void compareTexts(const QString& oldTitle, const QString& oldText, const QString& newTitle, const QString& newText);
+
+    static constexpr int maxRefineLength = 2000;
+
+protected:
+    void resizeEvent(QResizeEvent* event) override;
+
+private slots:
+    void onDiffFinished();
+
+private:
+    // أجزاء كل سطر التي تغيرت فعلاً، كمواضع وأطوال داخل السطر
+    struct LineRefinement {
+        QList<QPair<int, int>> oldRanges{};
+        QList<QPair<int, int>> newRanges{};
+    };
+
+    void startDiff(const QString& oldPath, const QString& oldText, const QString& newText);
+    void syncScroll(SPEditor* from, SPEditor* to, bool fromOld);
+    int mapLine(int line, bool fromOld) const;
+    void updateDecorations(SPEditor* pane, bool isOld);
+    const LineRefinement& refinement(int hunkIndex, int offset);
+
+    SPEditor* oldEditor{};
+    SPEditor* newEditor{};
+    QLabel* oldTitleLabel{};
+    QLabel* newTitleLabel{};
+    QLabel* summaryLabel{};
+
+    QFutureWatcher<SPDiffResult>* diffWatcher{};
+    QList<SPDiffHunk> hunks{};
+    QHash<qint64, LineRefinement> refinements{};
+    bool syncing{};
+};
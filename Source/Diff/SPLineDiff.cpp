@@ -0,0 +1,287 @@
+#include "SPLineDiff.h"
+
+#include <QHash>
+
+#include <vector>
+#include <cmath>
+
+
+namespace {
+
+// يحدد الأسطر المحذوفة من القديم والمضافة إلى الجديد
+// النطاقات تعالج بمكدس صريح بدلاً من الاستدعاء الذاتي لكي لا يمتلئ مكدس الخيط مع الملفات الكبيرة
+class MyersDiff {
+public:
+    MyersDiff(const QList<int>& a, const QList<int>& b)
+        : removed(size_t(a.size())), inserted(size_t(b.size())), a(a.constData()), b(b.constData()) {}
+
+    void run() {
+        struct Range {
+            int aLo, aHi, bLo, bHi;
+        };
+        std::vector<Range> pending{ { 0, int(removed.size()), 0, int(inserted.size()) } };
+
+        while (!pending.empty()) {
+            Range range = pending.back();
+            pending.pop_back();
+            int aLo = range.aLo, aHi = range.aHi, bLo = range.bLo, bHi = range.bHi;
+
+            while (aLo < aHi and bLo < bHi and a[aLo] == b[bLo]) {
+                ++aLo;
+                ++bLo;
+            }
+            while (aLo < aHi and bLo < bHi and a[aHi - 1] == b[bHi - 1]) {
+                --aHi;
+                --bHi;
+            }
+
+            if (aLo == aHi or bLo == bHi) {
+                markChanged(aLo, aHi, bLo, bHi);
+                continue;
+            }
+
+            int x{}, y{};
+            if (!bisect(aLo, aHi, bLo, bHi, x, y)) {
+                markChanged(aLo, aHi, bLo, bHi);
+                continue;
+            }
+            pending.push_back({ aLo + x, aHi, bLo + y, bHi });
+            pending.push_back({ aLo, aLo + x, bLo, bLo + y });
+        }
+    }
+
+    std::vector<bool> removed{};
+    std::vector<bool> inserted{};
+
+private:
+    void markChanged(int aLo, int aHi, int bLo, int bHi) {
+        for (int i = aLo; i < aHi; ++i) removed[size_t(i)] = true;
+        for (int j = bLo; j < bHi; ++j) inserted[size_t(j)] = true;
+    }
+
+    // يبحث عن "الأفعى الوسطى" بالسير من البداية والنهاية معاً حتى يلتقي المساران
+    // x و y موضع التقسيم نسبةً إلى بداية النطاق
+    bool bisect(int aLo, int aHi, int bLo, int bHi, int& x, int& y) {
+        const int n = aHi - aLo;
+        const int m = bHi - bLo;
+        // نصان مختلفان كلياً يجعلان البحث الدقيق بطيئاً جداً، فبعد حد معين يقسم النطاق
+        // عند أبعد نقطة وصل إليها المسار الأمامي، والنتيجة صحيحة لكنها قد لا تكون الأصغر
+        const int maxCost = qMax(256, int(std::sqrt(double(n + m))));
+        const int maxD = qMin((n + m + 1) / 2, maxCost + 1);
+        const int offset = maxD;
+        const int length = 2 * maxD + 2;
+
+        forward.assign(size_t(length), -1);
+        backward.assign(size_t(length), -1);
+        forward[size_t(offset + 1)] = 0;
+        backward[size_t(offset + 1)] = 0;
+
+        const int delta = n - m;
+        const bool front = (delta % 2) != 0;
+        int k1Start = 0, k1End = 0, k2Start = 0, k2End = 0;
+
+        for (int d = 0; d < maxD; ++d) {
+            if (d >= maxCost) {
+                return furthestForward(d, offset, n, m, k1Start, k1End, x, y);
+            }
+
+            for (int k1 = -d + k1Start; k1 <= d - k1End; k1 += 2) {
+                const int k1Offset = offset + k1;
+                int x1 = (k1 == -d or (k1 != d and forward[size_t(k1Offset - 1)] < forward[size_t(k1Offset + 1)]))
+                    ? forward[size_t(k1Offset + 1)]
+                    : forward[size_t(k1Offset - 1)] + 1;
+                int y1 = x1 - k1;
+                while (x1 < n and y1 < m and a[aLo + x1] == b[bLo + y1]) {
+                    ++x1;
+                    ++y1;
+                }
+                forward[size_t(k1Offset)] = x1;
+
+                if (x1 > n) {
+                    k1End += 2;
+                }
+                else if (y1 > m) {
+                    k1Start += 2;
+                }
+                else if (front) {
+                    const int k2Offset = offset + delta - k1;
+                    if (k2Offset >= 0 and k2Offset < length and backward[size_t(k2Offset)] != -1
+                        and x1 >= n - backward[size_t(k2Offset)]) {
+                        x = x1;
+                        y = y1;
+                        return true;
+                    }
+                }
+            }
+
+            for (int k2 = -d + k2Start; k2 <= d - k2End; k2 += 2) {
+                const int k2Offset = offset + k2;
+                int x2 = (k2 == -d or (k2 != d and backward[size_t(k2Offset - 1)] < backward[size_t(k2Offset + 1)]))
+                    ? backward[size_t(k2Offset + 1)]
+                    : backward[size_t(k2Offset - 1)] + 1;
+                int y2 = x2 - k2;
+                while (x2 < n and y2 < m and a[aHi - x2 - 1] == b[bHi - y2 - 1]) {
+                    ++x2;
+                    ++y2;
+                }
+                backward[size_t(k2Offset)] = x2;
+
+                if (x2 > n) {
+                    k2End += 2;
+                }
+                else if (y2 > m) {
+                    k2Start += 2;
+                }
+                else if (!front) {
+                    const int k1Offset = offset + delta - k2;
+                    if (k1Offset >= 0 and k1Offset < length and forward[size_t(k1Offset)] != -1) {
+                        const int x1 = forward[size_t(k1Offset)];
+                        const int y1 = offset + x1 - k1Offset;
+                        if (x1 >= n - x2) {
+                            x = x1;
+                            y = y1;
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    bool furthestForward(int d, int offset, int n, int m, int k1Start, int k1End, int& x, int& y) const {
+        int best = -1;
+        for (int k1 = -(d - 1) + k1Start; k1 <= (d - 1) - k1End; k1 += 2) {
+            const int x1 = forward[size_t(offset + k1)];
+            const int y1 = x1 - k1;
+            if (x1 < 0 or x1 > n or y1 < 0 or y1 > m) continue;
+            if (x1 + y1 > best and !(x1 == n and y1 == m)) {
+                best = x1 + y1;
+                x = x1;
+                y = y1;
+            }
+        }
+        return best > 0;
+    }
+
+    const int* a{};
+    const int* b{};
+    std::vector<int> forward{};
+    std::vector<int> backward{};
+};
+
+void splitLines(QStringView text, QList<QStringView>& lines) {
+    qsizetype start = 0;
+    for (qsizetype pos = text.indexOf('\n'); pos != -1; pos = text.indexOf('\n', start)) {
+        lines.append(text.mid(start, pos - start));
+        start = pos + 1;
+    }
+    lines.append(text.mid(start));
+}
+
+} // namespace
+
+
+void SPLineDiff::hashLines(QStringView oldText, QStringView newText, QList<int>& oldLines, QList<int>& newLines) {
+    QList<QStringView> oldViews{};
+    QList<QStringView> newViews{};
+    splitLines(oldText, oldViews);
+    splitLines(newText, newViews);
+
+    // الأرقام تعطى حسب المحتوى الكامل للسطر وليس حسب قيمة تجزئة، فلا يحدث تصادم
+    QHash<QStringView, int> ids{};
+    ids.reserve(oldViews.size() + newViews.size());
+    auto idFor = [&ids](QStringView line) {
+        auto it = ids.constFind(line);
+        if (it != ids.constEnd()) return it.value();
+        int id = int(ids.size());
+        ids.insert(line, id);
+        return id;
+    };
+
+    oldLines.reserve(oldViews.size());
+    for (QStringView line : std::as_const(oldViews)) oldLines.append(idFor(line));
+    newLines.reserve(newViews.size());
+    for (QStringView line : std::as_const(newViews)) newLines.append(idFor(line));
+}
+
+QList<SPDiffHunk> SPLineDiff::diff(const QList<int>& oldLines, const QList<int>& newLines) {
+    const int n = int(oldLines.size());
+    const int m = int(newLines.size());
+
+    // السطر الذي لا يوجد في النص الآخر إطلاقاً متغير حتماً، فيستبعد قبل Myers
+    // وهذا يجعل مقارنة ملفين أعيدت كتابتهما بالكامل سريعة
+    int idCount = 0;
+    for (int id : oldLines) idCount = qMax(idCount, id + 1);
+    for (int id : newLines) idCount = qMax(idCount, id + 1);
+    std::vector<quint8> inOld(static_cast<size_t>(idCount));
+    std::vector<quint8> inNew(static_cast<size_t>(idCount));
+    for (int id : oldLines) inOld[size_t(id)] = 1;
+    for (int id : newLines) inNew[size_t(id)] = 1;
+
+    QList<int> oldKept{}, newKept{};
+    QList<int> oldIndex{}, newIndex{};
+    for (int i = 0; i < n; ++i) {
+        if (inNew[size_t(oldLines.at(i))]) {
+            oldKept.append(oldLines.at(i));
+            oldIndex.append(i);
+        }
+    }
+    for (int j = 0; j < m; ++j) {
+        if (inOld[size_t(newLines.at(j))]) {
+            newKept.append(newLines.at(j));
+            newIndex.append(j);
+        }
+    }
+
+    MyersDiff myers(oldKept, newKept);
+    myers.run();
+
+    std::vector<bool> removed(size_t(n), true);
+    std::vector<bool> inserted(size_t(m), true);
+    for (qsizetype i = 0; i < oldIndex.size(); ++i) removed[size_t(oldIndex.at(i))] = myers.removed[size_t(i)];
+    for (qsizetype j = 0; j < newIndex.size(); ++j) inserted[size_t(newIndex.at(j))] = myers.inserted[size_t(j)];
+
+    QList<SPDiffHunk> hunks{};
+    int i = 0, j = 0;
+    while (i < n or j < m) {
+        if (i < n and j < m and !removed[size_t(i)] and !inserted[size_t(j)]) {
+            ++i;
+            ++j;
+            continue;
+        }
+
+        SPDiffHunk hunk{ i, 0, j, 0 };
+        while (i < n and removed[size_t(i)]) ++i;
+        while (j < m and inserted[size_t(j)]) ++j;
+        hunk.oldCount = i - hunk.oldStart;
+        hunk.newCount = j - hunk.newStart;
+        if (hunk.oldCount == 0 and hunk.newCount == 0) break;
+        hunks.append(hunk);
+    }
+    return hunks;
+}
+
+QList<SPDiffHunk> SPLineDiff::diffText(QStringView oldText, QStringView newText) {
+    QList<int> oldLines{};
+    QList<int> newLines{};
+    hashLines(oldText, newText, oldLines, newLines);
+    return diff(oldLines, newLines);
+}
+
+QList<SPLineMarker> SPLineDiff::lineMarkers(const QList<SPDiffHunk>& hunks) {
+    QList<SPLineMarker> markers{};
+    markers.reserve(hunks.size());
+    for (const SPDiffHunk& hunk : hunks) {
+        if (hunk.newCount == 0) {
+            markers.append({ hunk.newStart, 0, SPLineMarker::Deleted });
+        }
+        else if (hunk.oldCount == 0) {
+            markers.append({ hunk.newStart, hunk.newCount, SPLineMarker::Added });
+        }
+        else {
+            markers.append({ hunk.newStart, hunk.newCount, SPLineMarker::Modified });
+        }
+    }
+    return markers;
+}
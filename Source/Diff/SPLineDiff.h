@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+
+// مجموعة أسطر متتالية تختلف بين النصين، والأرقام تبدأ من 0
+// الحذف فقط: newCount = 0 و newStart هو السطر الذي يلي موضع الحذف
+// الإضافة فقط: oldCount = 0
+struct SPDiffHunk {
+    int oldStart{};
+    int oldCount{};
+    int newStart{};
+    int newCount{};
+};
+
+// علامة في هامش المحرر على أسطر النص الجديد
+struct SPLineMarker {
+    enum Kind : quint8 {
+        Added,
+        Modified,
+        Deleted,
+    };
+
+    int line{};
+    int count{};
+    Kind kind{};
+};
+
+
+// مقارنة الأسطر بخوارزمية Myers في مساحة خطية
+// كل سطر يحول أولاً إلى رقم صحيح، فالأسطر المتطابقة في النصين تأخذ نفس الرقم
+// وتصبح المقارنة بين أرقام فقط، مع تجاوز البداية والنهاية المشتركة قبل البحث
+// الدوال لا تستخدم حالة مشتركة، فيمكن استدعاؤها من أي خيط
+class SPLineDiff {
+public:
+    static void hashLines(QStringView oldText, QStringView newText, QList<int>& oldLines, QList<int>& newLines);
+    static QList<SPDiffHunk> diff(const QList<int>& oldLines, const QList<int>& newLines);
+    static QList<SPDiffHunk> diffText(QStringView oldText, QStringView newText);
+
+    static QList<SPLineMarker> lineMarkers(const QList<SPDiffHunk>& hunks);
+};
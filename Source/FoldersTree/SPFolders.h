@@ -1,8 +1,9 @@
 #pragma once
 
+#include "SPProjectTreeModel.h"
+
 #include <QDockWidget>
 #include <QTreeView>
-#include <QFileSystemModel>
 #include <QUrl>
 #include <QMessageBox>
 
@@ -11,31 +12,30 @@ class FolderTree : public QDockWidget {
     Q_OBJECT
 
 public:
-    explicit FolderTree(class SPEditor* textEditor, QWidget* parent = nullptr);
+    explicit FolderTree(QWidget* parent = nullptr);
 
     // Method to set root path for the file system model
     void setRootPath(const QString& path);
+    QString rootPath() const { return projectPath; }
 
 public slots:
     void openFolder();
+    // لقطة جديدة من فهرس المشروع
+    void setTable(const SPPathTablePtr& table);
+    void setGitStates(const SPGitStateMapPtr& states);
 
 private:
     void setupConnections();
-    QTreeView* treeView;
-    QFileSystemModel* fileModel;
-    SPEditor* textEditor;
-    QString projectPath;
+    QTreeView* treeView{};
+    SPProjectTreeModel* treeModel{};
+    QString projectPath{};
 
 signals:
     // Signal to emit when a file is selected
     void fileSelected(const QString& filePath);
-    // New signal to emit when a text file is opened
-    void textFileOpened(const QString& filePath, const QString& content);
     void folderChanged(const QString& newPath);
 
 private slots:
     // Slot to handle file selection
     void onFileDoubleClicked(const QModelIndex& index);
 };
-
-
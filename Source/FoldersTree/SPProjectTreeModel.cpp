@@ -0,0 +1,366 @@
+#include "SPProjectTreeModel.h"
+#include "SPTheme.h"
+
+#include <QFileInfo>
+#include <QDateTime>
+#include <QLocale>
+#include <QFileIconProvider>
+#include <QColor>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+
+namespace {
+
+// المجلدات أولاً ثم بالاسم بدون تمييز حالة الأحرف، والترتيب نفسه يستخدم عند دمج اللقطات
+int compareEntries(bool leftDir, QStringView left, bool rightDir, QStringView right) {
+    if (leftDir != rightDir) return leftDir ? -1 : 1;
+    int result = left.compare(right, Qt::CaseInsensitive);
+    return result != 0 ? result : left.compare(right, Qt::CaseSensitive);
+}
+
+} // namespace
+
+
+/* ---------------------------------- Listing ---------------------------------- */
+
+QStringView SPTreeListing::name(const Entry& entry) const {
+    if (!entry.isDir) {
+        return table->fileName(entry.id);
+    }
+    QStringView path = table->dirPath(entry.id);
+    qsizetype slash = path.lastIndexOf('/');
+    return slash == -1 ? path : path.mid(slash + 1);
+}
+
+SPTreeListingPtr SPTreeListing::build(const SPPathTablePtr& table) {
+    QSharedPointer<SPTreeListing> listing(new SPTreeListing());
+    listing->table = table;
+    if (!table) return listing;
+
+    listing->children.resize(table->dirCount());
+    listing->dirIds.reserve(table->dirCount());
+    for (int dir = 0; dir < table->dirCount(); ++dir) {
+        listing->dirIds.insert(table->dirPath(dir).toString(), dir);
+        int parent = table->dirParent(dir);
+        if (parent >= 0) {
+            listing->children[parent].append({ dir, true });
+        }
+    }
+    for (int file = 0; file < table->fileCount(); ++file) {
+        if (SPProjectTreeModel::isTextFile(table->fileName(file))) {
+            listing->children[table->fileDir(file)].append({ file, false });
+        }
+    }
+
+    const SPTreeListing* source = listing.data();
+    for (QList<Entry>& entries : listing->children) {
+        std::sort(entries.begin(), entries.end(), [source](const Entry& left, const Entry& right) {
+            return compareEntries(left.isDir, source->name(left), right.isDir, source->name(right)) < 0;
+        });
+    }
+    return listing;
+}
+
+
+/* ---------------------------------- Model ---------------------------------- */
+
+SPProjectTreeModel::SPProjectTreeModel(QObject* parent) : QAbstractItemModel(parent) {
+    root = std::make_unique<Node>();
+    root->isDir = true;
+    root->fetched = true;
+
+    QFileIconProvider iconProvider{};
+    folderIcon = iconProvider.icon(QAbstractFileIconProvider::Folder);
+    fileIcon = iconProvider.icon(QAbstractFileIconProvider::File);
+
+    listingWatcher = new QFutureWatcher<SPTreeListingPtr>(this);
+    connect(listingWatcher, &QFutureWatcher<SPTreeListingPtr>::finished, this, &SPProjectTreeModel::onListingReady);
+}
+
+SPProjectTreeModel::~SPProjectTreeModel() {
+    listingWatcher->waitForFinished();
+}
+
+bool SPProjectTreeModel::isTextFile(QStringView fileName) {
+    // List of text file extensions
+    static const QStringList textExtensions = { "alif", "aliflib", "txt", "log", "md", "csv",
+        "json", "xml", "html", "css", "js", "cpp", "h", "py" };
+
+    qsizetype dot = fileName.lastIndexOf('.');
+    if (dot == -1) return false;
+
+    QStringView ext = fileName.mid(dot + 1);
+    for (const QString& textExtension : textExtensions) {
+        if (ext.compare(textExtension, Qt::CaseInsensitive) == 0) return true;
+    }
+    return false;
+}
+
+void SPProjectTreeModel::setTable(const SPPathTablePtr& table) {
+    requestedTable = table;
+
+    // جذر جديد أو إغلاق المشروع يفرغ الشجرة، أما تحديثات نفس المشروع فتدمج مع العناصر المعروضة
+    if (!table or (listing and listing->table->rootPath() != table->rootPath())) {
+        beginResetModel();
+        root->children.clear();
+        root->dirId = -1;
+        listing.reset();
+        endResetModel();
+    }
+    if (!table) return;
+
+    listingWatcher->setFuture(QtConcurrent::run([table]() {
+        return SPTreeListing::build(table);
+    }));
+}
+
+void SPProjectTreeModel::onListingReady() {
+    SPTreeListingPtr next = listingWatcher->result();
+    if (!next or next->table != requestedTable) return;
+
+    SPTreeListingPtr previous = listing;
+    if (!previous) {
+        beginResetModel();
+        listing = next;
+        root->children.clear();
+        root->dirId = listing->dirIds.value(QString(), -1);
+        endResetModel();
+        return;
+    }
+
+    listing = next;
+    mergeNode(root.get(), previous);
+}
+
+// يطبق اللقطة الجديدة على أبناء العقدة المعروضين بدمج القائمتين المرتبتين
+// العناصر المعروضة تبقى دائماً بداية القائمة المرتبة لكي يكمل fetchMore من بعدها
+void SPProjectTreeModel::mergeNode(Node* node, const SPTreeListingPtr& previous) {
+    bool fullyFetched = node->dirId < 0
+        or qsizetype(node->children.size()) >= previous->children.at(node->dirId).size();
+
+    node->dirId = listing->dirIds.value(node->relPath, -1);
+    const QList<SPTreeListing::Entry> noEntries{};
+    const QList<SPTreeListing::Entry>& entries = node->dirId >= 0 ? listing->children.at(node->dirId) : noEntries;
+
+    qsizetype next = 0;
+    int row = 0;
+    while (row < int(node->children.size())) {
+        Node* child = node->children[row].get();
+
+        // العناصر المحذوفة المتتالية تزال دفعة واحدة
+        int removed = 0;
+        while (row + removed < int(node->children.size())) {
+            Node* candidate = node->children[row + removed].get();
+            if (next < entries.size() and compareEntries(candidate->isDir, candidate->name,
+                                                         entries.at(next).isDir, listing->name(entries.at(next))) >= 0) {
+                break;
+            }
+            ++removed;
+        }
+        if (removed > 0) {
+            removeChildren(node, row, removed);
+            continue;
+        }
+
+        // وكذلك العناصر الجديدة المتتالية تضاف دفعة واحدة
+        qsizetype added = 0;
+        while (next + added < entries.size() and compareEntries(child->isDir, child->name, entries.at(next + added).isDir,
+                                                               listing->name(entries.at(next + added))) > 0) {
+            ++added;
+        }
+        if (added > 0) {
+            insertChildren(node, row, entries.mid(next, added));
+            next += added;
+            row += int(added);
+            continue;
+        }
+
+        if (child->isDir) {
+            if (child->fetched) {
+                mergeNode(child, previous);
+            }
+            else {
+                child->dirId = listing->dirIds.value(child->relPath, -1);
+            }
+        }
+        ++next;
+        ++row;
+    }
+
+    if (fullyFetched and next < entries.size()) {
+        insertChildren(node, row, entries.mid(next));
+    }
+}
+
+void SPProjectTreeModel::setGitStates(const SPGitStateMapPtr& states) {
+    if (!gitStates and (!states or states->isEmpty())) return;
+    gitStates = states;
+    if (root) notifyGitChanged(root.get());
+}
+
+void SPProjectTreeModel::notifyGitChanged(Node* node) {
+    if (node->children.empty()) return;
+
+    QModelIndex parent = indexFor(node);
+    emit dataChanged(index(0, 0, parent), index(int(node->children.size()) - 1, 0, parent),
+                     { Qt::ForegroundRole, Qt::ToolTipRole });
+    for (const std::unique_ptr<Node>& child : node->children) {
+        notifyGitChanged(child.get());
+    }
+}
+
+QString SPProjectTreeModel::filePath(const QModelIndex& index) const {
+    Node* node = nodeFor(index);
+    if (!listing or !node) return QString();
+
+    QString rootPath = listing->table->rootPath();
+    return node->relPath.isEmpty() ? rootPath : rootPath + '/' + node->relPath;
+}
+
+bool SPProjectTreeModel::isDir(const QModelIndex& index) const {
+    Node* node = nodeFor(index);
+    return node and node->isDir;
+}
+
+QModelIndex SPProjectTreeModel::index(int row, int column, const QModelIndex& parent) const {
+    Node* node = nodeFor(parent);
+    if (column != 0 or row < 0 or row >= int(node->children.size())) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, node->children[row].get());
+}
+
+QModelIndex SPProjectTreeModel::parent(const QModelIndex& index) const {
+    if (!index.isValid()) return QModelIndex();
+    return indexFor(nodeFor(index)->parent);
+}
+
+int SPProjectTreeModel::rowCount(const QModelIndex& parent) const {
+    if (parent.column() > 0) return 0;
+    return int(nodeFor(parent)->children.size());
+}
+
+int SPProjectTreeModel::columnCount(const QModelIndex& parent) const {
+    Q_UNUSED(parent)
+    return 1;
+}
+
+bool SPProjectTreeModel::hasChildren(const QModelIndex& parent) const {
+    Node* node = nodeFor(parent);
+    return node->isDir and (!node->children.empty() or listingSize(node) > 0);
+}
+
+bool SPProjectTreeModel::canFetchMore(const QModelIndex& parent) const {
+    Node* node = nodeFor(parent);
+    return node->isDir and int(node->children.size()) < listingSize(node);
+}
+
+void SPProjectTreeModel::fetchMore(const QModelIndex& parent) {
+    Node* node = nodeFor(parent);
+    node->fetched = true;
+
+    int have = int(node->children.size());
+    int total = listingSize(node);
+    if (have >= total) return;
+
+    insertChildren(node, have, listing->children.at(node->dirId).mid(have, qMin(fetchBatch, total - have)));
+}
+
+QVariant SPProjectTreeModel::data(const QModelIndex& index, int role) const {
+    Node* node = nodeFor(index);
+    if (!index.isValid() or !node) return QVariant();
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return node->name;
+    case Qt::DecorationRole:
+        return node->isDir ? folderIcon : fileIcon;
+    case Qt::ForegroundRole: {
+        if (!gitStates or gitStates->isEmpty()) return QVariant();
+        const SPThemeColors& colors = SPTheme::instance().colors();
+        switch (gitStates->value(filePath(index), SPGitState::Clean)) {
+        case SPGitState::Clean: return QVariant();
+        case SPGitState::Untracked:
+        case SPGitState::Added: return colors.gitAdded;
+        case SPGitState::Deleted:
+        case SPGitState::Conflicted: return colors.gitDeleted;
+        default: return colors.gitModified;
+        }
+    }
+    case Qt::ToolTipRole: {
+        // تفاصيل الملف تقرأ من القرص فقط عند طلبها لعنصر ظاهر
+        QFileInfo info(filePath(index));
+        QString tip = info.filePath();
+        if (!node->isDir) {
+            tip = QString("%1\n%2\n%3").arg(tip,
+                                           QLocale().formattedDataSize(info.size()),
+                                           QLocale().toString(info.lastModified(), QLocale::ShortFormat));
+        }
+        if (gitStates and !node->isDir) {
+            QString state = SPGitStatus::stateName(gitStates->value(info.filePath(), SPGitState::Clean));
+            if (!state.isEmpty()) tip += "\ngit: " + state;
+        }
+        return tip;
+    }
+    case FilePathRole:
+        return filePath(index);
+    case IsDirRole:
+        return node->isDir;
+    default:
+        return QVariant();
+    }
+}
+
+SPProjectTreeModel::Node* SPProjectTreeModel::nodeFor(const QModelIndex& index) const {
+    return index.isValid() ? static_cast<Node*>(index.internalPointer()) : root.get();
+}
+
+QModelIndex SPProjectTreeModel::indexFor(Node* node) const {
+    if (!node or node == root.get()) return QModelIndex();
+    return createIndex(node->row, 0, node);
+}
+
+int SPProjectTreeModel::listingSize(const Node* node) const {
+    if (!listing or node->dirId < 0) return 0;
+    return int(listing->children.at(node->dirId).size());
+}
+
+std::unique_ptr<SPProjectTreeModel::Node> SPProjectTreeModel::makeNode(Node* parent, const SPTreeListing::Entry& entry) const {
+    std::unique_ptr<Node> node = std::make_unique<Node>();
+    node->name = listing->name(entry).toString();
+    node->relPath = parent->relPath.isEmpty() ? node->name : parent->relPath + '/' + node->name;
+    node->isDir = entry.isDir;
+    node->dirId = entry.isDir ? entry.id : -1;
+    node->parent = parent;
+    return node;
+}
+
+void SPProjectTreeModel::insertChildren(Node* node, int row, const QList<SPTreeListing::Entry>& entries) {
+    if (entries.isEmpty()) return;
+
+    beginInsertRows(indexFor(node), row, row + int(entries.size()) - 1);
+    std::vector<std::unique_ptr<Node>> created{};
+    created.reserve(entries.size());
+    for (const SPTreeListing::Entry& entry : entries) {
+        created.push_back(makeNode(node, entry));
+    }
+    node->children.insert(node->children.begin() + row,
+                          std::make_move_iterator(created.begin()), std::make_move_iterator(created.end()));
+    renumber(node, row);
+    endInsertRows();
+}
+
+void SPProjectTreeModel::removeChildren(Node* node, int row, int count) {
+    beginRemoveRows(indexFor(node), row, row + count - 1);
+    node->children.erase(node->children.begin() + row, node->children.begin() + row + count);
+    renumber(node, row);
+    endRemoveRows();
+}
+
+void SPProjectTreeModel::renumber(Node* node, int from) {
+    for (int row = from; row < int(node->children.size()); ++row) {
+        node->children[row]->row = row;
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "SPProjectIndex.h"
+#include "SPGitStatus.h"
+
+#include <QAbstractItemModel>
+#include <QFutureWatcher>
+#include <QIcon>
+
+#include <memory>
+#include <vector>
+
+
+// محتوى كل مجلد في لقطة من الفهرس مرتباً للعرض: المجلدات أولاً ثم الملفات
+// يبنى ويرتب في الخلفية، والعناصر تحمل أرقامها في الجدول فقط بدون نسخ الأسماء
+struct SPTreeListing {
+    struct Entry {
+        int id{};       // رقم المجلد أو الملف في الجدول
+        bool isDir{};
+    };
+
+    SPPathTablePtr table{};
+    QList<QList<Entry>> children{};     // حسب رقم المجلد
+    QHash<QString, int> dirIds{};       // المسار النسبي ← رقم المجلد
+
+    QStringView name(const Entry& entry) const;
+
+    static QSharedPointer<const SPTreeListing> build(const SPPathTablePtr& table);
+};
+
+using SPTreeListingPtr = QSharedPointer<const SPTreeListing>;
+
+
+// نموذج شجرة المشروع مبني على فهرس المشروع بدلاً من QFileSystemModel
+// أبناء المجلد تضاف على دفعات عبر canFetchMore و fetchMore فيفتح المجلد الضخم فوراً
+// ولا يقرأ شيء من القرص إلا تفاصيل العنصر الذي يطلب تلميحه
+class SPProjectTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+
+public:
+    explicit SPProjectTreeModel(QObject* parent = nullptr);
+    ~SPProjectTreeModel();
+
+    enum Roles {
+        FilePathRole = Qt::UserRole,
+        IsDirRole,
+    };
+
+    // يبني ترتيب اللقطة الجديدة في الخلفية ثم يطبق الفرق على العناصر المعروضة
+    void setTable(const SPPathTablePtr& table);
+    // يلون العناصر حسب حالتها في git ويحدث العناصر المعروضة فقط
+    void setGitStates(const SPGitStateMapPtr& states);
+
+    QString filePath(const QModelIndex& index) const;
+    bool isDir(const QModelIndex& index) const;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& index) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    static bool isTextFile(QStringView fileName);
+
+    static constexpr int fetchBatch = 1000;
+
+private slots:
+    void onListingReady();
+
+private:
+    struct Node {
+        QString name{};
+        QString relPath{};
+        bool isDir{};
+        int dirId{ -1 };
+        int row{};
+        bool fetched{};     // طلب العرض أبناءه مرة على الأقل فيتابع تغييراتها
+        Node* parent{};
+        std::vector<std::unique_ptr<Node>> children{};
+    };
+
+    Node* nodeFor(const QModelIndex& index) const;
+    QModelIndex indexFor(Node* node) const;
+    int listingSize(const Node* node) const;
+    std::unique_ptr<Node> makeNode(Node* parent, const SPTreeListing::Entry& entry) const;
+    void insertChildren(Node* node, int row, const QList<SPTreeListing::Entry>& entries);
+    void removeChildren(Node* node, int row, int count);
+    void mergeNode(Node* node, const SPTreeListingPtr& previous);
+    static void renumber(Node* node, int from);
+    void notifyGitChanged(Node* node);
+
+    std::unique_ptr<Node> root{};
+    SPTreeListingPtr listing{};
+    SPPathTablePtr requestedTable{};
+    QFutureWatcher<SPTreeListingPtr>* listingWatcher{};
+    SPGitStateMapPtr gitStates{};
+
+    QIcon folderIcon{};
+    QIcon fileIcon{};
+};
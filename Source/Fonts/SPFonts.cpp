@@ -0,0 +1,96 @@
+#include "SPFonts.h"
+
+#include <QFontDatabase>
+#include <QResource>
+#include <QTextLayout>
+#include <QPainter>
+#include <QImage>
+#include <QtMath>
+#include <QtConcurrent/QtConcurrentRun>
+
+
+static const char* const fontResources[] = {
+    ":/fonts/Resources/fonts/Tajawal/Tajawal-Regular.ttf",
+    ":/fonts/Resources/fonts/KawkabMono-Regular.ttf",
+};
+
+QFuture<QStringList>& SPFonts::registration() {
+    static QFuture<QStringList> future{};
+    return future;
+}
+
+QSet<QString>& SPFonts::warmedFonts() {
+    static QSet<QString> fonts{};
+    return fonts;
+}
+
+void SPFonts::registerInBackground() {
+    // قاعدة الخطوط محمية بقفل داخلي، فيمكن التسجيل من خيط آخر
+    registration() = QtConcurrent::run([]() {
+        QStringList result{};
+        for (const char* path : fontResources) {
+            QResource resource(path);
+            // الخطوط مخزنة بدون ضغط، فتقرأ من ذاكرة الملف التنفيذي المعينة دون نسخها
+            QByteArray data = resource.compressionAlgorithm() == QResource::NoCompression
+                                  ? QByteArray::fromRawData(reinterpret_cast<const char*>(resource.data()),
+                                                            resource.size())
+                                  : resource.uncompressedData();
+
+            int fontId = QFontDatabase::addApplicationFontFromData(data);
+            QStringList families = fontId == -1 ? QStringList() : QFontDatabase::applicationFontFamilies(fontId);
+            if (families.isEmpty()) return QStringList();
+            result.append(families.first());
+        }
+        return result;
+    });
+}
+
+QStringList SPFonts::families() {
+    return registration().isValid() ? registration().result() : QStringList();
+}
+
+QString SPFonts::sampleText(const QStringList& words) {
+    static const QString letters = "ءآأؤإئابةتثجحخدذرزسشصضطظعغفقكلمنهوىي";
+    static const QString tatweel = "ـ";
+
+    // كل حرف منفرداً وفي أول الكلمة ووسطها وآخرها، لأن لكل موضع شكلاً مختلفاً
+    QStringList parts{};
+    for (QChar letter : letters) {
+        parts << QString(letter)
+              << QString(letter) + tatweel
+              << tatweel + letter + tatweel
+              << tatweel + letter;
+    }
+    parts << "لا" << "لأ" << "لإ" << "لآ";
+    parts << "0123456789" << "٠١٢٣٤٥٦٧٨٩" << "()[]{}:،؛.,\"'=+-*/<>!#_%";
+    parts << words;
+    return parts.join(' ');
+}
+
+void SPFonts::warmUp(const QFont& font, const QStringList& words) {
+    QString key = font.key();
+    if (warmedFonts().contains(key)) return;
+    warmedFonts().insert(key);
+
+    QTextLayout layout(sampleText(words), font);
+    QTextOption option{};
+    option.setTextDirection(Qt::RightToLeft);
+    option.setWrapMode(QTextOption::WordWrap);
+    layout.setTextOption(option);
+
+    // التشكيل يحمل جداول الخط ويملأ ذاكرته، والرسم يملأ ذاكرة صور الأحرف التي يشاركها المحرر
+    const int width = 1024;
+    layout.beginLayout();
+    qreal height = 0;
+    for (QTextLine line = layout.createLine(); line.isValid(); line = layout.createLine()) {
+        line.setLineWidth(width);
+        line.setPosition(QPointF(0, height));
+        height += line.height();
+    }
+    layout.endLayout();
+
+    QImage image(width, qMax(1, qCeil(height)), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    layout.draw(&painter, QPointF(0, 0));
+}
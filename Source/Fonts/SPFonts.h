@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QFont>
+#include <QStringList>
+#include <QSet>
+#include <QFuture>
+
+
+// خطوط البرنامج: تسجل في خيط خلفي من بيانات الموارد مباشرة، وتهيأ أشكال حروفها في وقت الفراغ
+class SPFonts {
+public:
+    // يبدأ التسجيل، ويستدعى بعد إنشاء QApplication مباشرة
+    static void registerInBackground();
+    // ينتظر التسجيل إن لم ينته، ويرجع عائلات الخطوط بترتيب تسجيلها أو قائمة فارغة إن فشل أحدها
+    static QStringList families();
+
+    // يشكل الحروف العربية بأشكالها والأرقام والكلمات المعطاة ويرسمها مرة واحدة لكل خط وحجم
+    // لكي تجد أول الأحرف المكتوبة أشكالها وصورها جاهزة
+    static void warmUp(const QFont& font, const QStringList& words = {});
+
+private:
+    static QString sampleText(const QStringList& words);
+
+    static QFuture<QStringList>& registration();
+    static QSet<QString>& warmedFonts();
+};
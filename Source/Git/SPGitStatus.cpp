@@ -0,0 +1,327 @@
+#include "SPGitStatus.h"
+#include "SPTrace.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+
+
+SPGitStatus::SPGitStatus(QObject* parent) : QObject(parent) {
+    stateMap = SPGitStateMapPtr::create();
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setSingleShot(true);
+    refreshTimer->setInterval(refreshDelayMs);
+    connect(refreshTimer, &QTimer::timeout, this, &SPGitStatus::startStatus);
+
+    statusProcess = new QProcess(this);
+    connect(statusProcess, &QProcess::finished, this, &SPGitStatus::onStatusFinished);
+
+    parseWatcher = new QFutureWatcher<ParsedStatus>(this);
+    connect(parseWatcher, &QFutureWatcher<ParsedStatus>::finished, this, &SPGitStatus::onStatusParsed);
+
+    // git يكتب index و HEAD في ملف جديد ثم ينقله، فالمراقبة تعاد بعد كل تغيير
+    repositoryWatcher = new QFileSystemWatcher(this);
+    connect(repositoryWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString& path) {
+        if (QFileInfo::exists(path) and !repositoryWatcher->files().contains(path)) {
+            repositoryWatcher->addPath(path);
+        }
+        scheduleRefresh();
+    });
+
+    blobProcess = new QProcess(this);
+    connect(blobProcess, &QProcess::finished, this, &SPGitStatus::onBlobFinished);
+
+    diffWatcher = new QFutureWatcher<QList<SPLineMarker>>(this);
+    connect(diffWatcher, &QFutureWatcher<QList<SPLineMarker>>::finished, this, [this]() {
+        emit lineDiffReady(diffPath, diffWatcher->result());
+    });
+}
+
+SPGitStatus::~SPGitStatus() {
+    parseWatcher->waitForFinished();
+    diffWatcher->waitForFinished();
+}
+
+void SPGitStatus::setRootPath(const QString& path) {
+    QString cleanPath = QDir::cleanPath(path);
+    if (cleanPath == rootPath) return;
+
+    rootPath = cleanPath;
+    topLevel.clear();
+    rootPrefix.clear();
+    headOid.clear();
+    stateMap = SPGitStateMapPtr::create();
+    blobCache.clear();
+    missingInHead.clear();
+    if (!repositoryWatcher->files().isEmpty()) {
+        repositoryWatcher->removePaths(repositoryWatcher->files());
+    }
+    emit statusChanged();
+
+    // عملية المجلد السابق تكمل وحدها وتحذف عند انتهائها، فلا ينتظرها خيط الواجهة
+    if (topLevelProcess) {
+        topLevelProcess->disconnect(this);
+        if (topLevelProcess->state() == QProcess::NotRunning) {
+            topLevelProcess->deleteLater();
+        }
+        else {
+            connect(topLevelProcess, &QProcess::finished, topLevelProcess, &QObject::deleteLater);
+        }
+    }
+
+    topLevelProcess = new QProcess(this);
+    connect(topLevelProcess, &QProcess::finished, this, [this](int exitCode, QProcess::ExitStatus exitStatus) {
+        if (exitStatus != QProcess::NormalExit or exitCode != 0) return;
+
+        topLevel = QDir::cleanPath(QString::fromUtf8(topLevelProcess->readAllStandardOutput()).trimmed());
+        QString canonicalRoot = QFileInfo(rootPath).canonicalFilePath();
+        rootPrefix = canonicalRoot == topLevel ? QString() : QDir(topLevel).relativeFilePath(canonicalRoot);
+        if (rootPrefix.startsWith("..")) {
+            topLevel.clear();
+            rootPrefix.clear();
+            return;
+        }
+        watchRepository();
+        startStatus();
+    });
+    topLevelProcess->start("git", { "-C", rootPath, "rev-parse", "--show-toplevel" });
+}
+
+SPGitState SPGitStatus::state(const QString& absPath) const {
+    return stateMap->value(absPath, SPGitState::Clean);
+}
+
+QString SPGitStatus::stateName(SPGitState state) {
+    switch (state) {
+    case SPGitState::Untracked: return "غير متتبع";
+    case SPGitState::Added: return "مضاف";
+    case SPGitState::Modified: return "معدل";
+    case SPGitState::Deleted: return "محذوف";
+    case SPGitState::Renamed: return "أعيدت تسميته";
+    case SPGitState::Conflicted: return "تعارض";
+    default: return QString();
+    }
+}
+
+void SPGitStatus::scheduleRefresh() {
+    if (topLevel.isEmpty()) return;
+    refreshTimer->start();
+}
+
+void SPGitStatus::startStatus() {
+    if (topLevel.isEmpty()) return;
+
+    // تحديث واحد في كل مرة، والطلبات أثناءه تجمع في تحديث واحد بعده
+    if (statusProcess->state() != QProcess::NotRunning or parseWatcher->isRunning()) {
+        refreshPending = true;
+        return;
+    }
+    refreshPending = false;
+    statusProcess->start("git", { "-C", topLevel, "status", "--porcelain=v2", "-z", "--branch",
+                                  "--untracked-files=all" });
+}
+
+void SPGitStatus::onStatusFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (exitStatus != QProcess::NormalExit or exitCode != 0) {
+        if (refreshPending) startStatus();
+        return;
+    }
+
+    QByteArray output = statusProcess->readAllStandardOutput();
+    parseWatcher->setFuture(QtConcurrent::run([output, top = topLevel, root = rootPath, prefix = rootPrefix]() {
+        SP_TRACE_SCOPE("git.parseStatus");
+        return parseStatus(output, top, root, prefix);
+    }));
+}
+
+void SPGitStatus::onStatusParsed() {
+    ParsedStatus parsed = parseWatcher->result();
+    if (parsed.topLevel == topLevel and parsed.rootPath == rootPath) {
+        if (parsed.headOid != headOid) {
+            headOid = parsed.headOid;
+            blobCache.clear();
+            missingInHead.clear();
+        }
+        stateMap = parsed.states;
+        emit statusChanged();
+    }
+
+    if (refreshPending) {
+        startStatus();
+    }
+}
+
+// تنسيق porcelain v2 مع -z: سجلات مفصولة بـ NUL وعدد ثابت من الحقول قبل المسار
+// السجل "2" (إعادة تسمية) يتبعه سجل إضافي فيه المسار القديم
+// المسارات نسبة إلى جذر المستودع، وما هو خارج المجلد المفتوح لا يظهر في الشجرة فيتجاهل
+SPGitStatus::ParsedStatus SPGitStatus::parseStatus(const QByteArray& output, const QString& topLevel,
+                                                   const QString& rootPath, const QString& prefix) {
+    ParsedStatus result{};
+    result.rootPath = rootPath;
+    result.topLevel = topLevel;
+    QSharedPointer<SPGitStateMap> states(new SPGitStateMap());
+
+    QList<QByteArray> records = output.split('\0');
+    for (qsizetype i = 0; i < records.size(); ++i) {
+        const QByteArray& record = records.at(i);
+        if (record.size() < 2) continue;
+
+        char type = record.at(0);
+        QByteArray path{};
+        SPGitState state = SPGitState::Modified;
+
+        if (type == '#') {
+            if (record.startsWith("# branch.oid ")) {
+                result.headOid = QString::fromLatin1(record.mid(13));
+            }
+            continue;
+        }
+        else if (type == '?') {
+            path = record.mid(2);
+            state = SPGitState::Untracked;
+        }
+        else if (type == '1' or type == '2' or type == 'u') {
+            int fields = type == '1' ? 8 : type == '2' ? 9 : 10;
+            qsizetype pos = 0;
+            for (int field = 0; field < fields and pos != -1; ++field) {
+                qsizetype space = record.indexOf(' ', pos);
+                pos = space == -1 ? -1 : space + 1;
+            }
+            if (pos == -1) continue;
+            path = record.mid(pos);
+
+            QByteArray xy = record.mid(2, 2);
+            if (type == 'u') {
+                state = SPGitState::Conflicted;
+            }
+            else if (type == '2') {
+                state = SPGitState::Renamed;
+                ++i;
+            }
+            else if (xy.contains('D')) {
+                state = SPGitState::Deleted;
+            }
+            else if (xy.startsWith('A')) {
+                state = SPGitState::Added;
+            }
+        }
+        else {
+            continue;
+        }
+
+        QString relPath = QString::fromUtf8(path);
+        if (!prefix.isEmpty()) {
+            if (!relPath.startsWith(prefix + '/')) continue;
+            relPath = relPath.mid(prefix.size() + 1);
+        }
+        QString absPath = rootPath + '/' + relPath;
+        states->insert(absPath, state);
+
+        // المجلد يأخذ أعلى حالة بين أبنائه، والتوقف عند أول أب حالته أعلى لأن آباءه كذلك
+        for (qsizetype slash = absPath.lastIndexOf('/'); slash > rootPath.size(); slash = absPath.lastIndexOf('/', slash - 1)) {
+            SPGitState& dirState = (*states)[absPath.left(slash)];
+            if (dirState >= state) break;
+            dirState = state;
+        }
+    }
+
+    result.states = states;
+    return result;
+}
+
+void SPGitStatus::watchRepository() {
+    QString gitDir = topLevel + "/.git";
+    if (!QFileInfo(gitDir).isDir()) return;
+
+    for (const QString& name : { QString("index"), QString("HEAD") }) {
+        QString path = gitDir + '/' + name;
+        if (QFileInfo::exists(path)) {
+            repositoryWatcher->addPath(path);
+        }
+    }
+}
+
+QString SPGitStatus::repositoryPath(const QString& absPath) const {
+    if (topLevel.isEmpty()) return QString();
+
+    if (absPath.startsWith(rootPath + '/')) {
+        QString relPath = absPath.mid(rootPath.size() + 1);
+        return rootPrefix.isEmpty() ? relPath : rootPrefix + '/' + relPath;
+    }
+
+    // ملف من المستودع خارج المجلد المفتوح، فيطابق بمساره الحقيقي
+    QString canonicalPath = QFileInfo(absPath).canonicalFilePath();
+    if (canonicalPath.startsWith(topLevel + '/')) {
+        return canonicalPath.mid(topLevel.size() + 1);
+    }
+    return QString();
+}
+
+void SPGitStatus::requestLineDiff(const QString& absPath, const QString& text) {
+    diffRequest = {};
+    QString relPath = repositoryPath(absPath);
+    if (relPath.isEmpty() or state(absPath) == SPGitState::Untracked) {
+        emit lineDiffReady(absPath, {});
+        return;
+    }
+
+    diffRequest = { absPath, relPath, text };
+    if (blobCache.contains(diffRequest.relPath) or missingInHead.contains(diffRequest.relPath)) {
+        runLineDiff();
+    }
+    else {
+        fetchBlob(diffRequest.relPath);
+    }
+}
+
+void SPGitStatus::fetchBlob(const QString& relPath) {
+    // العملية الجارية تكمل، وعند انتهائها يجلب الملف المطلوب حينها
+    if (blobProcess->state() != QProcess::NotRunning) return;
+
+    blobRelPath = relPath;
+    blobProcess->start("git", { "-C", topLevel, "cat-file", "blob", "HEAD:" + relPath });
+}
+
+void SPGitStatus::onBlobFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (exitStatus == QProcess::NormalExit and exitCode == 0) {
+        if (blobCache.size() >= maxCachedBlobs) {
+            blobCache.erase(blobCache.begin());
+        }
+        blobCache.insert(blobRelPath, blobProcess->readAllStandardOutput());
+    }
+    else if (exitStatus == QProcess::NormalExit) {
+        missingInHead.insert(blobRelPath);
+    }
+
+    if (diffRequest.relPath.isEmpty()) return;
+    if (blobCache.contains(diffRequest.relPath) or missingInHead.contains(diffRequest.relPath)) {
+        runLineDiff();
+    }
+    else {
+        fetchBlob(diffRequest.relPath);
+    }
+}
+
+void SPGitStatus::runLineDiff() {
+    DiffRequest request = diffRequest;
+    diffRequest = {};
+
+    bool missing = missingInHead.contains(request.relPath);
+    QByteArray blob = blobCache.value(request.relPath);
+    SPGitState fileState = state(request.absPath);
+
+    diffPath = request.absPath;
+    diffWatcher->setFuture(QtConcurrent::run([blob, missing, fileState, text = request.text]() -> QList<SPLineMarker> {
+        if (missing) {
+            // ملف مضاف لم يدخل HEAD بعد، فكل أسطره جديدة
+            if (fileState != SPGitState::Added) return {};
+            return { { 0, int(text.count('\n')) + 1, SPLineMarker::Added } };
+        }
+
+        QString headText = QString::fromUtf8(blob);
+        headText.replace("\r\n", "\n");
+        return SPLineDiff::lineMarkers(SPLineDiff::diffText(headText, text));
+    }));
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "SPLineDiff.h"
+
+#include <QObject>
+#include <QProcess>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QSharedPointer>
+#include <QFutureWatcher>
+
+class QFileSystemWatcher;
+
+
+// الترتيب مهم: المجلد يأخذ أعلى حالة بين الملفات التي تحته
+enum class SPGitState : quint8 {
+    Clean,
+    Untracked,
+    Added,
+    Modified,
+    Deleted,
+    Renamed,
+    Conflicted,
+};
+
+// المسار المطلق تحت المجلد المفتوح ← الحالة، ويشمل المجلدات التي تحتوي تغييرات
+using SPGitStateMap = QHash<QString, SPGitState>;
+using SPGitStateMapPtr = QSharedPointer<const SPGitStateMap>;
+
+
+// حالة git لملفات المشروع وفروق أسطر المستند المفتوح عن HEAD
+// يستدعي git من سطر الأوامر بعمليات غير متزامنة، وتحليل المخرجات والمقارنة يتمان في خيوط خلفية
+// التحديث يُجمع بمؤقت قصير، ويطلب عند الحفظ وعند تغير الملفات وعند تغير .git/index أو .git/HEAD
+class SPGitStatus : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SPGitStatus(QObject* parent = nullptr);
+    ~SPGitStatus();
+
+    void setRootPath(const QString& path);
+    QString repositoryRoot() const { return topLevel; }
+
+    SPGitStateMapPtr states() const { return stateMap; }
+    SPGitState state(const QString& absPath) const;
+
+    static QString stateName(SPGitState state);
+
+    static constexpr int refreshDelayMs = 300;
+
+public slots:
+    void scheduleRefresh();
+    // النتيجة تصل عبر lineDiffReady، والطلب الأحدث يلغي ما قبله
+    void requestLineDiff(const QString& absPath, const QString& text);
+
+signals:
+    void statusChanged();
+    void lineDiffReady(const QString& absPath, const QList<SPLineMarker>& markers);
+
+private:
+    struct ParsedStatus {
+        QString rootPath{};
+        QString topLevel{};
+        SPGitStateMapPtr states{};
+        QString headOid{};
+    };
+
+    static ParsedStatus parseStatus(const QByteArray& output, const QString& topLevel,
+                                    const QString& rootPath, const QString& prefix);
+    // مسار الملف نسبة إلى جذر المستودع، وفارغ إذا لم يكن داخله
+    QString repositoryPath(const QString& absPath) const;
+
+    void startStatus();
+    void onStatusFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onStatusParsed();
+    void watchRepository();
+
+    void fetchBlob(const QString& relPath);
+    void onBlobFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void runLineDiff();
+
+    QString rootPath{};
+    QString topLevel{};
+    // مسار المجلد المفتوح داخل المستودع، لأن git يرجع جذره بعد حل الروابط الرمزية
+    // فالمسارات تعاد إلى المجلد كما فتحه المستخدم لتطابق مسارات الشجرة والمحرر
+    QString rootPrefix{};
+    QString headOid{};
+    SPGitStateMapPtr stateMap{};
+
+    QProcess* topLevelProcess{};
+    QProcess* statusProcess{};
+    QFutureWatcher<ParsedStatus>* parseWatcher{};
+    QTimer* refreshTimer{};
+    QFileSystemWatcher* repositoryWatcher{};
+    bool refreshPending{};
+
+    // محتوى الملفات في HEAD، ويفرغ عند تغير HEAD
+    QHash<QString, QByteArray> blobCache{};
+    QSet<QString> missingInHead{};
+    QProcess* blobProcess{};
+    QString blobRelPath{};
+
+    struct DiffRequest {
+        QString absPath{};
+        QString relPath{};
+        QString text{};
+    } diffRequest{};
+    QFutureWatcher<QList<SPLineMarker>>* diffWatcher{};
+    QString diffPath{};
+
+    static constexpr int maxCachedBlobs = 64;
+};
@@ -0,0 +1,80 @@
+#include "SPSingleInstance.h"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QDir>
+
+
+SPSingleInstance::SPSingleInstance(QObject* parent) : QObject(parent) {}
+
+// الاسم مرتبط بمجلد المستخدم فلا تتصل نسخ المستخدمين المختلفين ببعضها
+QString SPSingleInstance::serverName() {
+    return QString("Spectrum-%1").arg(qHash(QDir::homePath()), 0, 16);
+}
+
+bool SPSingleInstance::sendToRunning(const QStringList& files) {
+    QLocalSocket socket{};
+    socket.connectToServer(serverName());
+    if (!socket.waitForConnected(connectTimeoutMs)) return false;
+
+    // المسارات النسبية تخص مجلد هذا التشغيل، فترسل مطلقة
+    QStringList absoluteFiles{};
+    for (const QString& file : files) {
+        absoluteFiles.append(QFileInfo(file).absoluteFilePath());
+    }
+
+    QByteArray message{};
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out << absoluteFiles;
+    socket.write(message);
+    if (!socket.waitForBytesWritten(replyTimeoutMs)) return false;
+
+    // الرد يؤكد أن النسخة العاملة استلمت الرسالة كاملة قبل خروج هذا التشغيل
+    return socket.waitForReadyRead(replyTimeoutMs) and socket.read(1) == "1";
+}
+
+bool SPSingleInstance::listen() {
+    server = new QLocalServer(this);
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(server, &QLocalServer::newConnection, this, &SPSingleInstance::onNewConnection);
+
+    if (server->listen(serverName())) return true;
+
+    if (server->serverError() != QAbstractSocket::AddressInUseError) return false;
+
+    // الاسم محجوز، وقد تكون نسخة أخرى بدأت الاستماع بعد محاولة الاتصال الأولى
+    // فلا يحذف المقبس إلا إذا رفض الاتصال به، أي أنه متبقٍ من نسخة أغلقت بشكل غير طبيعي
+    QLocalSocket socket{};
+    socket.connectToServer(serverName());
+    if (socket.waitForConnected(connectTimeoutMs)) {
+        socket.disconnectFromServer();
+        return false;
+    }
+    if (socket.error() != QLocalSocket::ConnectionRefusedError
+        and socket.error() != QLocalSocket::ServerNotFoundError) {
+        return false;
+    }
+
+    QLocalServer::removeServer(serverName());
+    return server->listen(serverName());
+}
+
+void SPSingleInstance::onNewConnection() {
+    while (QLocalSocket* socket = server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            QDataStream in(socket);
+            in.startTransaction();
+            QStringList files{};
+            in >> files;
+            if (!in.commitTransaction()) return;
+
+            socket->write("1");
+            socket->flush();
+            socket->disconnectFromServer();
+            emit filesReceived(files);
+        });
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QObject>
+#include <QStringList>
+
+class QLocalServer;
+
+
+// نسخة واحدة من المحرر لكل مستخدم
+// التشغيل الثاني يرسل مسارات ملفاته إلى النسخة العاملة عبر مقبس محلي ثم يخرج فوراً
+// قبل تحميل الخطوط والأنماط والنافذة، والنسخة العاملة تفتحها عند وصولها
+class SPSingleInstance : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SPSingleInstance(QObject* parent = nullptr);
+
+    // يرجع true إن وجدت نسخة عاملة واستلمت الملفات
+    bool sendToRunning(const QStringList& files);
+    // تبدأ هذه النسخة باستقبال ملفات التشغيلات اللاحقة
+    bool listen();
+
+    static QString serverName();
+
+    static constexpr int connectTimeoutMs = 300;
+    static constexpr int replyTimeoutMs = 2000;
+
+signals:
+    void filesReceived(const QStringList& files);
+
+private slots:
+    void onNewConnection();
+
+private:
+    QLocalServer* server{};
+};
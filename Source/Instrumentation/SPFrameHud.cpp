@@ -0,0 +1,97 @@
+#include "SPFrameHud.h"
+#include "SPTheme.h"
+
+#include <QPainter>
+
+
+static QString formatMs(qint64 ns) {
+    return QString::number(ns / 1e6, 'f', 2);
+}
+
+
+SPFrameHud::SPFrameHud(QWidget* parent)
+    : QWidget(parent) {
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setFont(QFont("Kawkab Mono", 9));
+    resize(340, 150);
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(refreshIntervalMs);
+    connect(refreshTimer, &QTimer::timeout, this, qOverload<>(&QWidget::update));
+}
+
+void SPFrameHud::showEvent(QShowEvent* event) {
+    QWidget::showEvent(event);
+    SPFrameStats::acquire();
+    refreshTimer->start();
+}
+
+void SPFrameHud::hideEvent(QHideEvent* event) {
+    QWidget::hideEvent(event);
+    refreshTimer->stop();
+    SPFrameStats::release();
+}
+
+void SPFrameHud::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event)
+    const SPThemeColors& colors = SPTheme::instance().colors();
+    QList<SPFrameStats::Frame> frames = SPFrameStats::frames();
+
+    qint64 phaseTotal[SPFrameStats::PhaseCount]{};
+    qint64 lastFrame{};
+    qint64 maxFrame{};
+    qint64 intervalTotal{};
+    int relayouts{};
+    for (const SPFrameStats::Frame& frame : frames) {
+        qint64 frameNs = 0;
+        for (int phase = 0; phase < SPFrameStats::PhaseCount; ++phase) {
+            phaseTotal[phase] += frame.phaseNs[phase];
+            frameNs += frame.phaseNs[phase];
+        }
+        lastFrame = frameNs;
+        maxFrame = qMax(maxFrame, frameNs);
+        intervalTotal += frame.intervalNs;
+        relayouts += frame.relayouts;
+    }
+    qint64 count = qMax<qint64>(frames.size(), 1);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), colors.popup);
+    painter.setPen(colors.border);
+    painter.drawRect(rect().adjusted(0, 0, -1, -1));
+
+    // الأعمدة: زمن رسم كل إطار، والخط الأفقي حد 16 مللي ثانية
+    QRect graph(8, height() - 48, width() - 16, 40);
+    qint64 scaleNs = qMax<qint64>(maxFrame, 16000000);
+    qreal barWidth = qreal(graph.width()) / SPFrameStats::historySize;
+    for (int i = 0; i < frames.size(); ++i) {
+        qint64 frameNs = 0;
+        for (qint64 phaseNs : frames.at(i).phaseNs) frameNs += phaseNs;
+        qreal barHeight = qreal(graph.height()) * frameNs / scaleNs;
+        QRectF bar(graph.left() + i * barWidth, graph.bottom() - barHeight, qMax<qreal>(barWidth - 1, 1), barHeight);
+        painter.fillRect(bar, frameNs > 16000000 ? QColor(0xf1, 0x4c, 0x4c) : colors.accent);
+    }
+    int budgetY = graph.bottom() - int(qint64(graph.height()) * 16000000 / scaleNs);
+    painter.setPen(QPen(colors.mutedText, 1, Qt::DashLine));
+    painter.drawLine(graph.left(), budgetY, graph.right(), budgetY);
+
+    QStringList lines{};
+    lines << QString("الإطار: %1 مللي، الأقصى %2، الفاصل %3")
+                 .arg(formatMs(lastFrame), formatMs(maxFrame), formatMs(intervalTotal / count));
+    lines << QString("المحرر %1  الهامش %2  التحديد %3 (متوسط)")
+                 .arg(formatMs(phaseTotal[SPFrameStats::EditorPaint] / count),
+                      formatMs(phaseTotal[SPFrameStats::GutterPaint] / count),
+                      formatMs(phaseTotal[SPFrameStats::ExtraSelections] / count));
+    lines << QString("أسطر أعيد تخطيطها: %1 في %2 إطار")
+                 .arg(relayouts).arg(frames.size());
+    lines << QString("تأخر حلقة الأحداث: %1 مللي، الأقصى %2")
+                 .arg(formatMs(SPFrameStats::eventLoopLatencyNs()), formatMs(SPFrameStats::maxEventLoopLatencyNs()));
+
+    painter.setPen(colors.text);
+    int lineHeight = fontMetrics().height();
+    for (int i = 0; i < lines.size(); ++i) {
+        painter.drawText(QRect(8, 6 + i * lineHeight, width() - 16, lineHeight),
+                         Qt::AlignRight | Qt::AlignVCenter, lines.at(i));
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "SPFrameStats.h"
+
+#include <QWidget>
+#include <QTimer>
+
+
+// طبقة فوق المحرر تعرض أزمنة الإطارات الأخيرة ومراحل الرسم وإعادة التخطيط وتأخر حلقة الأحداث
+// معتمة لكي لا يعيد تحديثها رسم المحرر تحتها فيتأثر القياس بها
+class SPFrameHud : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit SPFrameHud(QWidget* parent = nullptr);
+
+    static constexpr int refreshIntervalMs = 250;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    QTimer* refreshTimer{};
+};
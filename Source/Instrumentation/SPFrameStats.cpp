@@ -0,0 +1,68 @@
+#include "SPFrameStats.h"
+
+#include <QTimer>
+#include <QCoreApplication>
+
+
+// مؤقت قياس تأخر حلقة الأحداث، يعمل فقط ما دامت هناك طبقة ظاهرة
+QTimer* SPFrameStats::latencyProbe() {
+    static QTimer* timer = [] {
+        QTimer* probe = new QTimer(QCoreApplication::instance());
+        probe->setTimerType(Qt::PreciseTimer);
+        probe->setInterval(latencyProbeMs);
+        QObject::connect(probe, &QTimer::timeout, &SPFrameStats::probeEventLoop);
+        return probe;
+    }();
+    return timer;
+}
+
+void SPFrameStats::acquire() {
+    if (users++) return;
+
+    enabled = true;
+    current = Frame{};
+    historyCount = 0;
+    historyNext = 0;
+    frameClock.invalidate();
+    latencyNs = 0;
+    maxLatencyNs = 0;
+    latencyClock.start();
+    latencyProbe()->start();
+}
+
+void SPFrameStats::release() {
+    if (!users or --users) return;
+
+    enabled = false;
+    latencyProbe()->stop();
+}
+
+void SPFrameStats::endFrame() {
+    if (!enabled) return;
+
+    current.intervalNs = frameClock.isValid() ? frameClock.nsecsElapsed() : 0;
+    frameClock.start();
+
+    history[historyNext] = current;
+    historyNext = (historyNext + 1) % historySize;
+    historyCount = qMin(historyCount + 1, historySize);
+    current = Frame{};
+}
+
+QList<SPFrameStats::Frame> SPFrameStats::frames() {
+    QList<Frame> result{};
+    result.reserve(historyCount);
+    int first = (historyNext - historyCount + historySize) % historySize;
+    for (int i = 0; i < historyCount; ++i) {
+        result.append(history[(first + i) % historySize]);
+    }
+    return result;
+}
+
+// التأخر هو الزمن الزائد عن فترة المؤقت، أي المدة التي كانت فيها الحلقة مشغولة بغيره
+void SPFrameStats::probeEventLoop() {
+    qint64 elapsed = latencyClock.nsecsElapsed();
+    latencyClock.start();
+    latencyNs = qMax<qint64>(0, elapsed - qint64(latencyProbeMs) * 1000000);
+    maxLatencyNs = qMax(maxLatencyNs, latencyNs);
+}
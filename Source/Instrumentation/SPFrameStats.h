@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QtGlobal>
+
+class QTimer;
+
+
+// قياسات رسم المحرر لطبقة زمن الإطارات، مبنية دائماً في البرنامج
+// ما دامت الطبقة مخفية فكل نقطة قياس هي قراءة متغير واحد فقط
+// تستخدم من خيط الواجهة فقط
+class SPFrameStats {
+public:
+    enum Phase {
+        EditorPaint,
+        GutterPaint,
+        ExtraSelections,
+        PhaseCount
+    };
+
+    struct Frame {
+        qint64 intervalNs{};            // الزمن منذ الإطار السابق
+        qint64 phaseNs[PhaseCount]{};
+        int relayouts{};                // أسطر أعيد تخطيطها منذ الإطار السابق
+    };
+
+    // يقيس زمن مرحلة من بداية النطاق إلى نهايته
+    class Scope {
+    public:
+        explicit Scope(Phase phase) : phase(phase) {
+            if (enabled) timer.start();
+        }
+        ~Scope() {
+            if (timer.isValid()) current.phaseNs[phase] += timer.nsecsElapsed();
+        }
+
+    private:
+        Phase phase{};
+        QElapsedTimer timer{};
+    };
+
+    static bool isEnabled() { return enabled; }
+    // كل طبقة ظاهرة تطلب القياس وتتركه عند إخفائها
+    static void acquire();
+    static void release();
+
+    static void countRelayout() {
+        if (enabled) ++current.relayouts;
+    }
+    // ينهي الإطار الحالي، ويستدعى في آخر رسم المحرر
+    static void endFrame();
+
+    // الإطارات الأخيرة من الأقدم إلى الأحدث
+    static QList<Frame> frames();
+    static qint64 eventLoopLatencyNs() { return latencyNs; }
+    static qint64 maxEventLoopLatencyNs() { return maxLatencyNs; }
+
+    static constexpr int historySize = 120;
+    static constexpr int latencyProbeMs = 50;
+
+private:
+    static QTimer* latencyProbe();
+    static void probeEventLoop();
+
+    static inline bool enabled{};
+    static inline int users{};
+    static inline Frame current{};
+    static inline Frame history[historySize]{};
+    static inline int historyCount{};
+    static inline int historyNext{};
+    static inline QElapsedTimer frameClock{};
+
+    static inline QElapsedTimer latencyClock{};
+    static inline qint64 latencyNs{};
+    static inline qint64 maxLatencyNs{};
+};
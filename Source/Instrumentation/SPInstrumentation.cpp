@@ -0,0 +1,44 @@
+#include "SPInstrumentation.h"
+
+
+void SPInstrumentation::registerProvider(const QString& title, Provider provider) {
+    QMutexLocker locker(&mutex());
+    sources().append({ title, std::move(provider) });
+}
+
+QList<SPMetricSection> SPInstrumentation::collect() {
+    QList<Source> current{};
+    {
+        QMutexLocker locker(&mutex());
+        current = sources();
+    }
+
+    // المصادر تستدعى خارج القفل لأن بعضها يأخذ أقفاله الخاصة
+    QList<SPMetricSection> sections{};
+    for (const Source& source : current) {
+        sections.append({ source.title, source.provider() });
+    }
+    return sections;
+}
+
+QString SPInstrumentation::formatBytes(qint64 bytes) {
+    if (bytes < 1024) return QString("%1 B").arg(bytes);
+    if (bytes < 1024 * 1024) return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+    if (bytes < 1024LL * 1024 * 1024) return QString("%1 MB").arg(bytes / (1024.0 * 1024), 0, 'f', 1);
+    return QString("%1 GB").arg(bytes / (1024.0 * 1024 * 1024), 0, 'f', 2);
+}
+
+QString SPInstrumentation::formatPercent(quint64 part, quint64 total) {
+    if (total == 0) return "-";
+    return QString("%1%").arg(100.0 * part / total, 0, 'f', 1);
+}
+
+QMutex& SPInstrumentation::mutex() {
+    static QMutex lock{};
+    return lock;
+}
+
+QList<SPInstrumentation::Source>& SPInstrumentation::sources() {
+    static QList<Source> list{};
+    return list;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+
+#include <functional>
+
+
+struct SPMetric {
+    QString name{};
+    QString value{};
+};
+
+struct SPMetricSection {
+    QString title{};
+    QList<SPMetric> metrics{};
+};
+
+
+// سجل مصادر القياسات التي تعرضها لوحة الأداء
+// كل خدمة تسجل دالة ترجع قيمها الحالية، واللوحة تستدعيها دورياً من خيط الواجهة
+class SPInstrumentation {
+public:
+    using Provider = std::function<QList<SPMetric>()>;
+
+    static void registerProvider(const QString& title, Provider provider);
+    static QList<SPMetricSection> collect();
+
+    static QString formatBytes(qint64 bytes);
+    static QString formatPercent(quint64 part, quint64 total);
+
+private:
+    struct Source {
+        QString title{};
+        Provider provider{};
+    };
+
+    static QMutex& mutex();
+    static QList<Source>& sources();
+};
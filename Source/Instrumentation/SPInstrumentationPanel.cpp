@@ -0,0 +1,68 @@
+#include "SPInstrumentationPanel.h"
+
+#include <QHeaderView>
+
+
+SPInstrumentationPanel::SPInstrumentationPanel(QWidget* parent)
+    : QDockWidget(parent) {
+    setWindowTitle("لوحة الأداء");
+    setFont(QFont("Tajawal"));
+    setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetClosable);
+
+    metricsTree = new QTreeWidget(this);
+    metricsTree->setColumnCount(2);
+    metricsTree->setHeaderHidden(true);
+    metricsTree->setUniformRowHeights(true);
+    metricsTree->setRootIsDecorated(false);
+    metricsTree->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    metricsTree->setFrameShape(QFrame::NoFrame);
+    setWidget(metricsTree);
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(refreshIntervalMs);
+    connect(refreshTimer, &QTimer::timeout, this, &SPInstrumentationPanel::refresh);
+}
+
+void SPInstrumentationPanel::showEvent(QShowEvent* event) {
+    QDockWidget::showEvent(event);
+    refresh();
+    refreshTimer->start();
+}
+
+void SPInstrumentationPanel::hideEvent(QHideEvent* event) {
+    QDockWidget::hideEvent(event);
+    refreshTimer->stop();
+}
+
+void SPInstrumentationPanel::refresh() {
+    QList<SPMetricSection> sections = SPInstrumentation::collect();
+
+    // يعاد استخدام العناصر الموجودة لكي لا يضيع التمرير والتحديد مع كل تحديث
+    int row = 0;
+    auto itemAt = [this, &row]() {
+        QTreeWidgetItem* item = metricsTree->topLevelItem(row);
+        if (!item) item = new QTreeWidgetItem(metricsTree);
+        ++row;
+        return item;
+    };
+
+    for (const SPMetricSection& section : sections) {
+        QTreeWidgetItem* header = itemAt();
+        header->setText(0, section.title);
+        header->setText(1, QString());
+        QFont font = header->font(0);
+        font.setBold(true);
+        header->setFont(0, font);
+
+        for (const SPMetric& metric : section.metrics) {
+            QTreeWidgetItem* item = itemAt();
+            item->setText(0, "    " + metric.name);
+            item->setText(1, metric.value);
+            item->setFont(0, metricsTree->font());
+        }
+    }
+
+    while (metricsTree->topLevelItemCount() > row) {
+        delete metricsTree->takeTopLevelItem(row);
+    }
+}
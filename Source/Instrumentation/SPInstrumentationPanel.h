@@ -0,0 +1,29 @@
+#pragma once
+
+#include "SPInstrumentation.h"
+
+#include <QDockWidget>
+#include <QTreeWidget>
+#include <QTimer>
+
+
+// لوحة الأداء، تعرض قيم المصادر المسجلة وتحدثها كل ثانية ما دامت ظاهرة
+class SPInstrumentationPanel : public QDockWidget {
+    Q_OBJECT
+
+public:
+    explicit SPInstrumentationPanel(QWidget* parent = nullptr);
+
+    static constexpr int refreshIntervalMs = 1000;
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private slots:
+    void refresh();
+
+private:
+    QTreeWidget* metricsTree{};
+    QTimer* refreshTimer{};
+};
@@ -0,0 +1,124 @@
+#include "SPMemory.h"
+#include "SPLayoutCache.h"
+
+#include <QTextDocument>
+#include <QTextLayout>
+#include <QFile>
+
+
+void SPMemory::registerReporter(const QString& name, Reporter reporter, QObject* owner) {
+    QMutexLocker locker(&mutex());
+    sources().append({ name, std::move(reporter), owner, owner != nullptr });
+}
+
+void SPMemory::trackDocument(QTextDocument* document, std::function<QString()> name) {
+    QMutexLocker locker(&mutex());
+    documents().append({ document, std::move(name) });
+}
+
+SPDocumentMemory SPMemory::documentUsage(const QTextDocument* document) {
+    SPDocumentMemory usage{};
+    usage.text = qint64(document->characterCount()) * qint64(sizeof(QChar))
+               + qint64(document->blockCount()) * bytesPerBlock;
+    usage.undo = qint64(document->availableUndoSteps() + document->availableRedoSteps()) * bytesPerUndoStep;
+
+    // الأسطر المخططة تؤخذ من عدادات ذاكرة التخطيط، لأن طلب تخطيط كل سطر هنا ينشئ تخطيطاً لما لم يخطط بعد
+    // ويمر على كل أسطر المستند في خيط الواجهة مع كل تحديث للوحة
+    SPLayoutCache::DocumentUsage laidOut = SPLayoutCache::instance().documentUsage(document);
+    usage.layout = qint64(laidOut.lines) * bytesPerLine;
+    usage.formats = qint64(laidOut.formats) * qint64(sizeof(QTextLayout::FormatRange));
+    return usage;
+}
+
+qint64 SPMemory::residentBytes() {
+    return statusValue("VmRSS:");
+}
+
+qint64 SPMemory::peakResidentBytes() {
+    return statusValue("VmHWM:");
+}
+
+QList<SPMetric> SPMemory::metrics() {
+    QList<Source> currentSources{};
+    QList<Document> currentDocuments{};
+    {
+        QMutexLocker locker(&mutex());
+        sources().removeIf([](const Source& source) { return source.owned and source.owner.isNull(); });
+        documents().removeIf([](const Document& document) { return document.document.isNull(); });
+        currentSources = sources();
+        currentDocuments = documents();
+    }
+
+    QList<SPMetric> metrics{};
+    qint64 resident = residentBytes();
+    if (resident >= 0) {
+        metrics.append({ "الذاكرة المقيمة", SPInstrumentation::formatBytes(resident) });
+        metrics.append({ "أعلى ذاكرة مقيمة", SPInstrumentation::formatBytes(peakResidentBytes()) });
+    }
+
+    qint64 accounted = 0;
+    for (const Document& document : currentDocuments) {
+        SPDocumentMemory usage = documentUsage(document.document);
+        QString name = document.name();
+        accounted += usage.total();
+        metrics.append({ name, SPInstrumentation::formatBytes(usage.total()) });
+        metrics.append({ name + ": النص", SPInstrumentation::formatBytes(usage.text) });
+        metrics.append({ name + ": التخطيط", SPInstrumentation::formatBytes(usage.layout) });
+        metrics.append({ name + ": التراجع", SPInstrumentation::formatBytes(usage.undo) });
+        metrics.append({ name + ": التلوين", SPInstrumentation::formatBytes(usage.formats) });
+    }
+
+    // المصادر تستدعى خارج القفل لأن بعضها يأخذ أقفاله الخاصة
+    for (const Source& source : currentSources) {
+        SPMemoryUsage usage = source.reporter();
+        accounted += usage.bytes;
+        QString value = SPInstrumentation::formatBytes(usage.bytes);
+        if (usage.budget > 0) {
+            value += " / " + SPInstrumentation::formatBytes(usage.budget)
+                   + " (" + SPInstrumentation::formatPercent(quint64(usage.bytes), quint64(usage.budget)) + ")";
+        }
+        metrics.append({ source.name, value });
+    }
+
+    metrics.append({ "المجموع المحسوب", SPInstrumentation::formatBytes(accounted) });
+    if (resident > 0) {
+        metrics.append({ "نسبته من المقيمة", SPInstrumentation::formatPercent(quint64(accounted), quint64(resident)) });
+    }
+    return metrics;
+}
+
+qint64 SPMemory::statusValue(const QByteArray& field) {
+#if defined(Q_OS_LINUX)
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly)) return -1;
+
+    // السطر بالشكل "VmRSS:     123456 kB"
+    for (const QByteArray& line : file.readAll().split('\n')) {
+        if (!line.startsWith(field)) continue;
+        QByteArray value = line.mid(field.size()).trimmed();
+        value.chop(value.endsWith("kB") ? 2 : 0);
+        bool ok{};
+        qint64 kilobytes = value.trimmed().toLongLong(&ok);
+        return ok ? kilobytes * 1024 : -1;
+    }
+    return -1;
+#else
+    Q_UNUSED(field);
+    return -1;
+#endif
+}
+
+QMutex& SPMemory::mutex() {
+    static QMutex lock{};
+    return lock;
+}
+
+QList<SPMemory::Source>& SPMemory::sources() {
+    static QList<Source> list{};
+    return list;
+}
+
+QList<SPMemory::Document>& SPMemory::documents() {
+    static QList<Document> list{};
+    return list;
+}
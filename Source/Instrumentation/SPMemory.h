@@ -0,0 +1,72 @@
+#pragma once
+
+#include "SPInstrumentation.h"
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QPointer>
+
+#include <functional>
+
+class QTextDocument;
+
+
+// ذاكرة خدمة واحدة، والميزانية صفر تعني أن الخدمة غير محدودة
+struct SPMemoryUsage {
+    qint64 bytes{};
+    qint64 budget{};
+};
+
+// تقدير ذاكرة مستند مفتوح بحسب أجزائه، والأرقام تقريبية مبنية على أحجام بنى Qt الداخلية
+struct SPDocumentMemory {
+    qint64 text{};          // النص وبيانات الأسطر
+    qint64 layout{};        // الأسطر المخططة في SPLayoutCache، وأشكال حروفها تحسب مع ذاكرة التخطيط المشتركة
+    qint64 undo{};          // خطوات التراجع والإعادة
+    qint64 formats{};       // تنسيقات التلوين للأسطر المخططة نفسها
+    qint64 total() const { return text + layout + undo + formats; }
+};
+
+
+// محاسبة الذاكرة: كل خدمة تسجل دالة ترجع ما تستخدمه وميزانيتها، وكل مستند مفتوح يتابع بأجزائه
+// النتيجة قسم واحد في لوحة الأداء يقارن مجموع المحسوب بالذاكرة المقيمة للبرنامج
+// فيظهر أي ميزانية تحتاج ضبطاً عندما يكبر البرنامج في الجلسات الطويلة
+class SPMemory {
+public:
+    using Reporter = std::function<SPMemoryUsage()>;
+
+    // يحذف المصدر مع owner إن أعطي، لأن دالته تستخدم كائناً يملكه
+    static void registerReporter(const QString& name, Reporter reporter, QObject* owner = nullptr);
+    static void trackDocument(QTextDocument* document, std::function<QString()> name);
+
+    static SPDocumentMemory documentUsage(const QTextDocument* document);
+    // من /proc/self/status، و-1 حيث لا يتوفر
+    static qint64 residentBytes();
+    static qint64 peakResidentBytes();
+
+    static QList<SPMetric> metrics();
+
+    static constexpr qint64 bytesPerBlock = 96;
+    static constexpr qint64 bytesPerLine = 64;
+    static constexpr qint64 bytesPerShapedChar = 24;
+    static constexpr qint64 bytesPerUndoStep = 80;
+
+private:
+    struct Source {
+        QString name{};
+        Reporter reporter{};
+        QPointer<QObject> owner{};
+        bool owned{};
+    };
+
+    struct Document {
+        QPointer<QTextDocument> document{};
+        std::function<QString()> name{};
+    };
+
+    static qint64 statusValue(const QByteArray& field);
+
+    static QMutex& mutex();
+    static QList<Source>& sources();
+    static QList<Document>& documents();
+};
@@ -0,0 +1,141 @@
+#include "SPStartupTrace.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QWidget>
+#include <QEvent>
+#include <QTimer>
+
+
+namespace {
+
+struct TraceState {
+    QElapsedTimer clock{};
+    qint64 lastNs{};
+    QList<SPStartupTrace::Phase> phases{};
+    bool printTrace{};
+    qint64 budgetMs{ -1 };
+    bool finished{};
+};
+
+TraceState& state() {
+    static TraceState trace{};
+    if (!trace.clock.isValid()) trace.clock.start();
+    return trace;
+}
+
+// الرسم الأول لأي عنصر في النافذة، والعلامة توضع بعد انتهاء دورة الرسم كاملة
+class FirstPaintFilter : public QObject {
+public:
+    explicit FirstPaintFilter(QWidget* window) : QObject(window), window(window) {}
+
+    bool eventFilter(QObject* watched, QEvent* event) override {
+        if (!seen and event->type() == QEvent::Paint and watched->isWidgetType()
+            and static_cast<QWidget*>(watched)->window() == window) {
+            seen = true;
+            QCoreApplication::instance()->removeEventFilter(this);
+            QTimer::singleShot(0, this, [this]() {
+                SPStartupTrace::mark("أول رسم");
+                SPStartupTrace::finish();
+                deleteLater();
+            });
+        }
+        return false;
+    }
+
+private:
+    QWidget* window{};
+    bool seen{};
+};
+
+} // namespace
+
+
+void SPStartupTrace::start() {
+    state();
+}
+
+void SPStartupTrace::configure(QStringList& arguments) {
+    TraceState& trace = state();
+    for (qsizetype i = arguments.size() - 1; i >= 1; --i) {
+        const QString& argument = arguments.at(i);
+        if (argument == "--startup-trace") {
+            trace.printTrace = true;
+            arguments.removeAt(i);
+        }
+        else if (argument.startsWith("--startup-budget=")) {
+            bool ok{};
+            qint64 budget = argument.mid(17).toLongLong(&ok);
+            if (ok and budget > 0) trace.budgetMs = budget;
+            arguments.removeAt(i);
+        }
+    }
+}
+
+void SPStartupTrace::mark(const QString& phase) {
+    TraceState& trace = state();
+    if (trace.finished) return;
+
+    qint64 now = trace.clock.nsecsElapsed();
+    trace.phases.append({ phase, trace.lastNs, now });
+    trace.lastNs = now;
+}
+
+void SPStartupTrace::watchFirstPaint(QWidget* window) {
+    QCoreApplication::instance()->installEventFilter(new FirstPaintFilter(window));
+}
+
+void SPStartupTrace::finish() {
+    TraceState& trace = state();
+    if (trace.finished) return;
+    trace.finished = true;
+
+    bool overBudget = trace.budgetMs > 0 and totalNs() > trace.budgetMs * 1000000;
+    if (trace.printTrace or trace.budgetMs > 0) {
+        QTextStream err(stderr);
+        err << report();
+        if (trace.budgetMs > 0) {
+            err << (overBudget ? "تجاوز" : "ضمن") << " الميزانية: " << trace.budgetMs << " ms\n";
+        }
+        err.flush();
+    }
+
+    // وضع الفحص: البرنامج يغلق بعد القياس ورمز الخروج هو النتيجة
+    if (trace.budgetMs > 0) {
+        QCoreApplication::exit(overBudget ? 1 : 0);
+    }
+}
+
+bool SPStartupTrace::isActive() {
+    return state().printTrace or state().budgetMs > 0;
+}
+
+QList<SPStartupTrace::Phase> SPStartupTrace::phases() {
+    return state().phases;
+}
+
+qint64 SPStartupTrace::totalNs() {
+    return state().lastNs;
+}
+
+QList<SPMetric> SPStartupTrace::metrics() {
+    QList<SPMetric> metrics{};
+    for (const Phase& phase : std::as_const(state().phases)) {
+        metrics.append({ phase.name, QString("%1 ms").arg((phase.endNs - phase.startNs) / 1e6, 0, 'f', 1) });
+    }
+    metrics.append({ "المجموع", QString("%1 ms").arg(totalNs() / 1e6, 0, 'f', 1) });
+    return metrics;
+}
+
+QString SPStartupTrace::report() {
+    QString text = "تتبع بدء التشغيل:\n";
+    for (const Phase& phase : std::as_const(state().phases)) {
+        text += QString("  %1 %2 ms  (عند %3 ms)\n")
+                    .arg(phase.name, -28)
+                    .arg((phase.endNs - phase.startNs) / 1e6, 8, 'f', 1)
+                    .arg(phase.endNs / 1e6, 0, 'f', 1);
+    }
+    text += QString("  %1 %2 ms\n").arg("المجموع", -28).arg(totalNs() / 1e6, 8, 'f', 1);
+    return text;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SPInstrumentation.h"
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+class QWidget;
+
+
+// تتبع مراحل بدء التشغيل بتوقيت رتيب من أول سطر في main حتى أول رسم للنافذة
+// كل علامة تنهي المرحلة الحالية وتبدأ التالية، والتسجيل دائم لأنه رخيص
+// ويستخدم من خيط الواجهة فقط
+//
+// --startup-trace          يطبع المراحل بعد أول رسم
+// --startup-budget=<ms>    يقارن الزمن الكلي بالميزانية ثم يغلق البرنامج
+//                          برمز خروج 1 إن تجاوزها، ليستخدم في فحص آلي
+class SPStartupTrace {
+public:
+    struct Phase {
+        QString name{};
+        qint64 startNs{};
+        qint64 endNs{};
+    };
+
+    static void start();
+    // يزيل خيارات التتبع من المعاملات فتبقى معاملات البرنامج كما هي
+    static void configure(QStringList& arguments);
+    static void mark(const QString& phase);
+    // يسجل أول رسم لهذه النافذة ثم ينهي التتبع
+    static void watchFirstPaint(QWidget* window);
+    static void finish();
+    // القياس يحتاج تشغيلاً كاملاً، فلا يرسل الملفات إلى نسخة عاملة
+    static bool isActive();
+
+    static QList<Phase> phases();
+    static qint64 totalNs();
+    static QList<SPMetric> metrics();
+
+private:
+    static QString report();
+};
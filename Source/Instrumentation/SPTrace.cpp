@@ -0,0 +1,260 @@
+#include "SPTrace.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QThread>
+#include <QMutex>
+#include <QFile>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+
+namespace {
+
+struct Event {
+    const char* name{};
+    qint64 startNs{};
+    qint64 durationNs{};
+};
+
+// حلقة خيط واحد: يكتب فيها خيطها فقط، ويقرأها الحفظ من خيط الواجهة
+// head عدد الأحداث المكتوبة منذ البداية، وfirst أول حدث بعد آخر تفريغ
+struct Ring {
+    int threadId{};
+    QString threadName{};
+    std::atomic<quint64> head{};
+    std::atomic<quint64> first{};
+    Event events[SPTrace::ringSize]{};
+};
+
+struct Registry {
+    QMutex mutex{};
+    std::vector<std::unique_ptr<Ring>> rings{};
+    // حلقات خيوط انتهت، بترتيب انتهائها، وأحداثها تبقى محفوظة حتى يأخذها خيط جديد
+    std::deque<Ring*> retired{};
+    int lastThreadId{};
+};
+
+Registry& registry() {
+    static Registry rings{};
+    return rings;
+}
+
+const QElapsedTimer& clock() {
+    static QElapsedTimer timer = []() {
+        QElapsedTimer started{};
+        started.start();
+        return started;
+    }();
+    return timer;
+}
+
+QString& outputPath() {
+    static QString path{};
+    return path;
+}
+
+// يعيد حلقة الخيط إلى قائمة الحلقات المتاحة عند انتهائه
+struct RingOwner {
+    Ring* ring{};
+
+    ~RingOwner() {
+        if (!ring) return;
+        Registry& rings = registry();
+        QMutexLocker locker(&rings.mutex);
+        rings.retired.push_back(ring);
+    }
+};
+
+thread_local RingOwner localRing{};
+
+// الحلقة تنشأ عند أول حدث في الخيط، وبعد انتهائه تبقى أحداثه حتى تحفظ أو يحتاج خيط جديد حلقته
+// الخيوط المؤقتة كثيرة، فالحلقة الأقدم انتهاءً تعطى للخيط الجديد بدلاً من إنشاء حلقة أخرى
+Ring* threadRing() {
+    if (localRing.ring) return localRing.ring;
+
+    Registry& rings = registry();
+    QMutexLocker locker(&rings.mutex);
+    Ring* ring{};
+    if (!rings.retired.empty()) {
+        ring = rings.retired.front();
+        rings.retired.pop_front();
+        ring->first.store(ring->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    else {
+        rings.rings.push_back(std::make_unique<Ring>());
+        ring = rings.rings.back().get();
+    }
+    ring->threadId = ++rings.lastThreadId;
+
+    QThread* thread = QThread::currentThread();
+    QCoreApplication* app = QCoreApplication::instance();
+    if (app and thread == app->thread()) ring->threadName = "الواجهة";
+    else if (!thread->objectName().isEmpty()) ring->threadName = thread->objectName();
+    else ring->threadName = QString("خيط %1").arg(ring->threadId);
+
+    localRing.ring = ring;
+    return ring;
+}
+
+// الأحداث الصالحة في الحلقة، وما استبدله الكاتب أثناء النسخ يحذف
+QList<Event> snapshot(const Ring& ring) {
+    quint64 head = ring.head.load(std::memory_order_acquire);
+    quint64 from = qMax(ring.first.load(std::memory_order_relaxed),
+                        head > quint64(SPTrace::ringSize) ? head - SPTrace::ringSize : 0);
+
+    QList<Event> events{};
+    events.reserve(qsizetype(head - from));
+    for (quint64 i = from; i < head; ++i) events.append(ring.events[i % SPTrace::ringSize]);
+
+    quint64 after = ring.head.load(std::memory_order_acquire);
+    quint64 overwritten = after > quint64(SPTrace::ringSize) ? after - SPTrace::ringSize : 0;
+    if (overwritten > from) events.remove(0, qMin(events.size(), qsizetype(overwritten - from)));
+    return events;
+}
+
+} // namespace
+
+
+void SPTrace::setEnabled(bool on) {
+    clock();
+    setMode(Recording, on);
+}
+
+void SPTrace::setScopeStackEnabled(bool on) {
+    onGuiThread = on;
+    setMode(ScopeStack, on);
+}
+
+QStringList SPTrace::guiScopeStack() {
+    int depth = qMin(guiDepth.load(std::memory_order_acquire), int(stackSize));
+    QStringList scopes{};
+    for (int i = 0; i < depth; ++i) {
+        if (const char* name = guiStack[i]) scopes.append(QString::fromUtf8(name));
+    }
+    return scopes;
+}
+
+void SPTrace::clear() {
+    Registry& rings = registry();
+    QMutexLocker locker(&rings.mutex);
+    for (const std::unique_ptr<Ring>& ring : rings.rings) {
+        ring->first.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+void SPTrace::configure(QStringList& arguments) {
+    for (qsizetype i = arguments.size() - 1; i >= 1; --i) {
+        const QString& argument = arguments.at(i);
+        if (argument == "--trace" and i + 1 < arguments.size()) {
+            outputPath() = arguments.at(i + 1);
+            arguments.remove(i, 2);
+        }
+        else if (argument.startsWith("--trace=")) {
+            outputPath() = argument.mid(8);
+            arguments.removeAt(i);
+        }
+    }
+    if (outputPath().isEmpty()) return;
+
+    setEnabled(true);
+    QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, []() {
+        QTextStream err(stderr);
+        if (write(outputPath())) err << "التتبع: " << outputPath() << "\n";
+        else err << "لا يمكن كتابة ملف التتبع: " << outputPath() << "\n";
+    });
+}
+
+bool SPTrace::write(const QString& path) {
+    QJsonArray traceEvents{};
+    qint64 pid = QCoreApplication::applicationPid();
+
+    Registry& rings = registry();
+    QMutexLocker locker(&rings.mutex);
+    for (const std::unique_ptr<Ring>& ring : rings.rings) {
+        traceEvents.append(QJsonObject{
+            { "name", "thread_name" },
+            { "ph", "M" },
+            { "pid", pid },
+            { "tid", ring->threadId },
+            { "args", QJsonObject{ { "name", ring->threadName } } },
+        });
+
+        for (const Event& event : snapshot(*ring)) {
+            traceEvents.append(QJsonObject{
+                { "name", event.name },
+                { "cat", "spectrum" },
+                { "ph", "X" },
+                { "ts", event.startNs / 1e3 },
+                { "dur", event.durationNs / 1e3 },
+                { "pid", pid },
+                { "tid", ring->threadId },
+            });
+        }
+    }
+    locker.unlock();
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QJsonObject trace{ { "traceEvents", traceEvents }, { "displayTimeUnit", "ms" } };
+    return file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) > 0;
+}
+
+qsizetype SPTrace::eventCount() {
+    Registry& rings = registry();
+    QMutexLocker locker(&rings.mutex);
+    qsizetype count = 0;
+    for (const std::unique_ptr<Ring>& ring : rings.rings) {
+        quint64 recorded = ring->head.load(std::memory_order_relaxed) - ring->first.load(std::memory_order_relaxed);
+        count += qsizetype(qMin(recorded, quint64(ringSize)));
+    }
+    return count;
+}
+
+qsizetype SPTrace::memoryUsage() {
+    Registry& rings = registry();
+    QMutexLocker locker(&rings.mutex);
+    return qsizetype(rings.rings.size() * sizeof(Ring));
+}
+
+void SPTrace::setMode(Mode flag, bool on) {
+    if (on) mode.fetch_or(flag, std::memory_order_relaxed);
+    else mode.fetch_and(~flag, std::memory_order_relaxed);
+}
+
+// العمق يزداد حتى بعد امتلاء المكدس لكي يبقى الخروج متوازناً
+void SPTrace::Scope::enter(const char* name, int active) {
+    if (active & ScopeStack and onGuiThread) {
+        int depth = guiDepth.load(std::memory_order_relaxed);
+        if (depth < stackSize) guiStack[depth] = name;
+        guiDepth.store(depth + 1, std::memory_order_release);
+        pushed = true;
+    }
+    if (active & Recording) {
+        recording = true;
+        startNs = now();
+    }
+    if (pushed or recording) eventName = name;
+}
+
+void SPTrace::Scope::leave() {
+    if (recording) record(eventName, startNs, now() - startNs);
+    if (pushed) guiDepth.fetch_sub(1, std::memory_order_release);
+}
+
+qint64 SPTrace::now() {
+    return clock().nsecsElapsed();
+}
+
+void SPTrace::record(const char* name, qint64 startNs, qint64 durationNs) {
+    Ring* ring = threadRing();
+    quint64 head = ring->head.load(std::memory_order_relaxed);
+    ring->events[head % ringSize] = { name, startNs, durationNs };
+    ring->head.store(head + 1, std::memory_order_release);
+}
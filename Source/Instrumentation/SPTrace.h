@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+
+#include <atomic>
+
+
+// مسجل أحداث بصيغة Chrome trace يفتح في Perfetto أو chrome://tracing
+// كل خيط يكتب في حلقة خاصة به دون أقفال، والأقدم يستبدل عند امتلائها
+// ما دام التسجيل متوقفاً فكل نقطة تتبع خارج خيط الواجهة قراءة متغيرين ثم قفزة
+// وفي خيط الواجهة يضاف اسمها إلى مكدس النطاقات فقط ما دام مراقب التجمد يعمل
+//
+// --trace <ملف>    يبدأ التسجيل من أول البرنامج ويكتب الأحداث في الملف عند إغلاقه
+class SPTrace {
+public:
+    // يقيس زمن النطاق ويسجله حدثاً كاملاً، والاسم نص ثابت لا ينسخ
+    class Scope {
+    public:
+        explicit Scope(const char* name) {
+            int active = mode.load(std::memory_order_relaxed);
+            if (active & Recording or (active & ScopeStack and onGuiThread)) enter(name, active);
+        }
+        ~Scope() {
+            if (eventName) leave();
+        }
+
+    private:
+        void enter(const char* name, int active);
+        void leave();
+
+        const char* eventName{};
+        qint64 startNs{};
+        bool recording{};
+        bool pushed{};
+    };
+
+    static bool isEnabled() { return mode.load(std::memory_order_relaxed) & Recording; }
+    static void setEnabled(bool on);
+
+    // مكدس النطاقات المفتوحة في خيط الواجهة، يقرأه مراقب التجمد من خيطه
+    // يفعل من خيط الواجهة، فبقية الخيوط لا تدخل enter بسببه، والقراءة أثناء التجمد آمنة لأن الأسماء نصوص ثابتة
+    static void setScopeStackEnabled(bool on);
+    static QStringList guiScopeStack();
+    // يفرغ حلقات كل الخيوط، ويستدعى قبل بدء تسجيل جديد
+    static void clear();
+
+    static void configure(QStringList& arguments);
+    // يكتب الأحداث المسجلة من كل الخيوط مرتبة حسب الخيط، ويرجع false إن تعذرت الكتابة
+    static bool write(const QString& path);
+    static qsizetype eventCount();
+    // حلقة الخيط المنتهي تعطى لأول خيط جديد، فالحجم بعدد الخيوط التي سجلت أحداثاً في وقت واحد
+    static qsizetype memoryUsage();
+
+    static constexpr int ringSize = 16384;
+    static constexpr int stackSize = 64;
+
+private:
+    enum Mode {
+        Recording = 1,
+        ScopeStack = 2
+    };
+
+    static qint64 now();
+    static void record(const char* name, qint64 startNs, qint64 durationNs);
+    static void setMode(Mode flag, bool on);
+
+    static inline std::atomic<int> mode{};
+    static inline thread_local bool onGuiThread{};
+    static inline const char* guiStack[stackSize]{};
+    static inline std::atomic<int> guiDepth{};
+};
+
+
+#define SP_TRACE_CONCAT_(a, b) a##b
+#define SP_TRACE_CONCAT(a, b) SP_TRACE_CONCAT_(a, b)
+#define SP_TRACE_SCOPE(name) SPTrace::Scope SP_TRACE_CONCAT(spTraceScope, __LINE__)(name)
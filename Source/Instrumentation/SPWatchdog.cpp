@@ -0,0 +1,214 @@
+#include "SPWatchdog.h"
+#include "SPTrace.h"
+#include "SPConfig.h"
+
+#include <QThread>
+#include <QElapsedTimer>
+#include <QStandardPaths>
+#include <QTextDocument>
+#include <QTextStream>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#if defined(Q_OS_LINUX) and __has_include(<execinfo.h>)
+#define SP_NATIVE_BACKTRACE
+#include <execinfo.h>
+#include <pthread.h>
+#include <csignal>
+#include <cstdlib>
+#endif
+
+
+namespace {
+
+constexpr int pollMs = 10;
+
+#ifdef SP_NATIVE_BACKTRACE
+// مكدس خيط الواجهة يؤخذ من داخله: المراقب يرسل إشارة، ومعالجها يملأ المصفوفة
+constexpr int maxFrames = 64;
+void* frames[maxFrames]{};
+std::atomic<int> frameCount{ -1 };
+pthread_t guiThreadHandle{};
+
+void captureFrames(int) {
+    frameCount.store(backtrace(frames, maxFrames), std::memory_order_release);
+}
+
+// backtrace تحمل مكتبتها عند أول استدعاء، فتستدعى مرة هنا قبل أن تستخدم داخل المعالج
+void installBacktraceHandler() {
+    backtrace(frames, 1);
+    guiThreadHandle = pthread_self();
+
+    struct sigaction action{};
+    action.sa_handler = captureFrames;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR2, &action, nullptr);
+}
+
+QStringList guiBacktrace() {
+    frameCount.store(-1, std::memory_order_relaxed);
+    if (pthread_kill(guiThreadHandle, SIGUSR2) != 0) return {};
+    for (int i = 0; i < 100 and frameCount.load(std::memory_order_acquire) < 0; ++i) {
+        QThread::msleep(1);
+    }
+
+    int count = frameCount.load(std::memory_order_acquire);
+    QStringList lines{};
+    if (count <= 0) return lines;
+    if (char** symbols = backtrace_symbols(frames, count)) {
+        // الإطار الأول هو معالج الإشارة نفسه
+        for (int i = 1; i < count; ++i) lines.append(QString::fromLocal8Bit(symbols[i]));
+        std::free(symbols);
+    }
+    return lines;
+}
+#endif
+
+} // namespace
+
+
+SPWatchdog& SPWatchdog::instance() {
+    static SPWatchdog watchdog{};
+    return watchdog;
+}
+
+void SPWatchdog::start() {
+    if (thread) return;
+
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    path = directory.isEmpty() ? QString() : directory + "/stalls.log";
+
+    captureBacktrace = SPConfig::instance().value(backtraceKey, false).toBool();
+#ifdef SP_NATIVE_BACKTRACE
+    if (captureBacktrace) installBacktraceHandler();
+#else
+    captureBacktrace = false;
+#endif
+
+    SPTrace::setScopeStackEnabled(true);
+    stopping.store(false);
+    thread = QThread::create([this]() { watch(); });
+    thread->setObjectName("مراقب التجمد");
+    thread->start();
+}
+
+void SPWatchdog::stop() {
+    if (!thread) return;
+
+    stopping.store(true);
+    thread->wait();
+    delete thread;
+    thread = nullptr;
+    SPTrace::setScopeStackEnabled(false);
+}
+
+void SPWatchdog::setDocument(QTextDocument* target) {
+    document = target;
+}
+
+QString SPWatchdog::logPath() const {
+    return path;
+}
+
+QList<SPMetric> SPWatchdog::metrics() const {
+    int count = stallCount.load(std::memory_order_relaxed);
+    qint64 total = totalMs.load(std::memory_order_relaxed);
+    return {
+        { "مرات التجمد", QString::number(count) },
+        { "أطول تجمد", QString("%1 مللي ثانية").arg(longestMs.load(std::memory_order_relaxed)) },
+        { "متوسط التجمد", QString("%1 مللي ثانية").arg(count ? total / count : 0) },
+        { "مكدس الاستدعاءات", captureBacktrace ? "مفعل" : "متوقف" },
+        { "السجل", path.isEmpty() ? "غير متاح" : path },
+    };
+}
+
+// تنفذ في خيط الواجهة، فوصولها يعني أن حلقة الأحداث عادت تعمل
+void SPWatchdog::answerPing(quint64 sequence) {
+    answered.store(sequence, std::memory_order_release);
+    if (document) {
+        blocks.store(document->blockCount(), std::memory_order_relaxed);
+        characters.store(document->characterCount(), std::memory_order_relaxed);
+    }
+}
+
+void SPWatchdog::watch() {
+    QElapsedTimer clock{};
+    clock.start();
+    quint64 sequence = 0;
+
+    auto waiting = [&]() {
+        return !stopping.load() and answered.load(std::memory_order_acquire) < sequence;
+    };
+
+    while (!stopping.load()) {
+        ++sequence;
+        qint64 sentMs = clock.elapsed();
+        QMetaObject::invokeMethod(this, [this, sequence]() { answerPing(sequence); }, Qt::QueuedConnection);
+
+        while (waiting() and clock.elapsed() - sentMs < stallThresholdMs) QThread::msleep(pollMs);
+        if (stopping.load()) break;
+
+        if (!waiting()) {
+            qint64 left = pingIntervalMs - (clock.elapsed() - sentMs);
+            if (left > 0) QThread::msleep(left);
+            continue;
+        }
+
+        // الواجهة متجمدة الآن، فيؤخذ ما يصف حالتها قبل أن تعود
+        Stall stall{
+            .time = QDateTime::currentDateTime().addMSecs(sentMs - clock.elapsed()),
+            .scopes = SPTrace::guiScopeStack(),
+            .blocks = blocks.load(std::memory_order_relaxed),
+            .characters = characters.load(std::memory_order_relaxed),
+        };
+#ifdef SP_NATIVE_BACKTRACE
+        if (captureBacktrace) stall.backtrace = guiBacktrace();
+#endif
+
+        while (waiting()) QThread::msleep(pollMs);
+        stall.durationMs = clock.elapsed() - sentMs;
+
+        stallCount.fetch_add(1, std::memory_order_relaxed);
+        totalMs.fetch_add(stall.durationMs, std::memory_order_relaxed);
+        if (stall.durationMs > longestMs.load(std::memory_order_relaxed)) {
+            longestMs.store(stall.durationMs, std::memory_order_relaxed);
+        }
+
+        writeLog(stall);
+        emit stallDetected(stall.durationMs, summary(stall));
+    }
+}
+
+// السجل يدور عند تجاوز الحد: القديم يصبح stalls.1.log ويبدأ ملف جديد
+void SPWatchdog::writeLog(const Stall& stall) const {
+    if (path.isEmpty()) return;
+
+    QFileInfo info(path);
+    QDir().mkpath(info.absolutePath());
+    if (info.exists() and info.size() > logLimitBytes) {
+        QString previous = info.absolutePath() + "/stalls.1.log";
+        QFile::remove(previous);
+        QFile::rename(path, previous);
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) return;
+
+    QTextStream out(&file);
+    out << stall.time.toString(Qt::ISODateWithMs) << "  تجمد " << stall.durationMs << " مللي ثانية\n";
+    out << "  النطاقات: " << (stall.scopes.isEmpty() ? "لا يوجد" : stall.scopes.join(" > ")) << "\n";
+    out << "  المستند: " << stall.blocks << " سطر، " << stall.characters << " حرف\n";
+    if (!stall.backtrace.isEmpty()) {
+        out << "  مكدس الاستدعاءات:\n";
+        for (const QString& frame : stall.backtrace) out << "    " << frame << "\n";
+    }
+    out << "\n";
+}
+
+QString SPWatchdog::summary(const Stall& stall) {
+    QString text = QString("تجمدت الواجهة %1 مللي ثانية").arg(stall.durationMs);
+    if (!stall.scopes.isEmpty()) text += " أثناء " + stall.scopes.last();
+    return text;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "SPInstrumentation.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <QDateTime>
+
+#include <atomic>
+
+class QThread;
+class QTextDocument;
+
+
+// مراقب تجمد الواجهة: خيط مستقل يرسل نبضة إلى حلقة أحداث الواجهة كل pingIntervalMs
+// إن لم ترد خلال stallThresholdMs يحفظ مكدس نطاقات التتبع المفتوحة وحجم المستند
+// ومكدس استدعاءات خيط الواجهة إن كان مفعلاً في الإعدادات، ثم ينتظر عودتها ليعرف مدة التجمد
+// كل تجمد يكتب في سجل محلي دوار ويرسل ملخصه إلى شريط الحالة
+class SPWatchdog : public QObject {
+    Q_OBJECT
+
+public:
+    struct Stall {
+        QDateTime time{};
+        qint64 durationMs{};
+        QStringList scopes{};
+        int blocks{};
+        int characters{};
+        QStringList backtrace{};
+    };
+
+    static SPWatchdog& instance();
+
+    // يستدعى من خيط الواجهة بعد إنشاء النافذة
+    void start();
+    void stop();
+    // مستند النافذة النشطة، وحجمه يقرأ عند كل نبضة ناجحة فيصفه كما كان قبل التجمد
+    void setDocument(QTextDocument* document);
+
+    QString logPath() const;
+    QList<SPMetric> metrics() const;
+
+    static constexpr int pingIntervalMs = 100;
+    static constexpr int stallThresholdMs = 200;
+    static constexpr qint64 logLimitBytes = 256 * 1024;
+    static constexpr const char* backtraceKey = "watchdogBacktrace";
+
+signals:
+    // ترسل من خيط المراقب، فتصل إلى خيط الواجهة بعد انتهاء التجمد
+    void stallDetected(qint64 durationMs, const QString& summary);
+
+private:
+    SPWatchdog() = default;
+
+    void watch();
+    void answerPing(quint64 sequence);
+    void writeLog(const Stall& stall) const;
+    static QString summary(const Stall& stall);
+
+    QThread* thread{};
+    QString path{};
+    QPointer<QTextDocument> document{};
+    bool captureBacktrace{};
+
+    std::atomic<bool> stopping{};
+    std::atomic<quint64> answered{};
+    std::atomic<int> blocks{};
+    std::atomic<int> characters{};
+    std::atomic<int> stallCount{};
+    std::atomic<qint64> longestMs{};
+    std::atomic<qint64> totalMs{};
+};
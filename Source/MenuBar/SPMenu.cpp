@@ -2,55 +2,45 @@
 
 SPMenuBar::SPMenuBar(QWidget* parent) {
 
-    parent->setStyleSheet(R"(
-        QMenuBar {
-            color: #dddddd;
-            background-color: #1e202e;
-            spacing: 5px; /* spacing between menu bar items */
-        }
-
-        QMenuBar::item {
-            padding: 3px 7px;
-            background: transparent;
-            border-radius: 1px;
-        }
-
-        QMenuBar::item:selected { /* when selected using mouse or keyboard */
-            background: #303349;
-        }
-
-        QMenuBar::item:pressed {
-            background: #373a54;
-        }
-    )");
-
     QMenu* fileMenu = addMenu("ملف");
-    //QMenu* editMenu = addMenu("تحرير");
+    QMenu* editMenu = addMenu("تحرير");
+    QMenu* viewMenu = addMenu("عرض");
     QMenu* runMenu = addMenu("تشغيل");
     QMenu* helpMenu = addMenu("مساعدة");
 
     fileMenu->setMinimumWidth(200);
-    //editMenu->setMinimumWidth(200);
+    editMenu->setMinimumWidth(200);
+    viewMenu->setMinimumWidth(200);
     runMenu->setMinimumWidth(200);
     helpMenu->setMinimumWidth(200);
 
-    //QAction* folderAction = new QAction("فتح مجلد", parent);
+    QAction* folderAction = new QAction("فتح مجلد", parent);
     QAction* newAction = new QAction("جديد", parent);
     QAction* openAction = new QAction("فتح", parent);
+    QAction* quickOpenAction = new QAction("فتح سريع\tCtrl+P", parent);
     QAction* saveAction = new QAction("حفظ", parent);
     QAction* saveAsAction = new QAction("حفظ باسم", parent);
     QAction* SettingsAction = new QAction("الإعدادات", parent);
     QAction* exitAction = new QAction("خروج", parent);
 
+    QAction* projectSearchAction = new QAction("بحث في المشروع\tCtrl+Shift+F", parent);
+
+    QAction* instrumentationAction = new QAction("لوحة الأداء", parent);
+    QAction* frameHudAction = new QAction("أزمنة الرسم فوق المحرر\tCtrl+Shift+H", parent);
+    QAction* traceAction = new QAction("بدء أو حفظ تتبع الأداء", parent);
+    QAction* compareSavedAction = new QAction("مقارنة مع الملف المحفوظ", parent);
+    QAction* compareFileAction = new QAction("مقارنة مع ملف آخر", parent);
+
     QAction* runAction = new QAction("تشغيل", parent);
 
     QAction* aboutAction = new QAction("عن المحرر", parent);
 
 
-    //fileMenu->addAction(folderAction);
-    //fileMenu->addSeparator();
+    fileMenu->addAction(folderAction);
+    fileMenu->addSeparator();
     fileMenu->addAction(newAction);
     fileMenu->addAction(openAction);
+    fileMenu->addAction(quickOpenAction);
     fileMenu->addAction(saveAction);
     fileMenu->addAction(saveAsAction);
     fileMenu->addSeparator();
@@ -58,49 +48,40 @@ SPMenuBar::SPMenuBar(QWidget* parent) {
     fileMenu->addSeparator();
     fileMenu->addAction(exitAction);
 
+    editMenu->addAction(projectSearchAction);
+
+    viewMenu->addAction(instrumentationAction);
+    viewMenu->addAction(frameHudAction);
+    viewMenu->addAction(traceAction);
+    viewMenu->addSeparator();
+    viewMenu->addAction(compareSavedAction);
+    viewMenu->addAction(compareFileAction);
+
     runMenu->addAction(runAction);
 
     helpMenu->addAction(aboutAction);
 
 
-    QString style = R"(
-        QMenu {
-            color: #dddddd;
-            background-color: #1e202e;
-            border-bottom: 1px solid #10a8f4;
-            border-left: 1px solid #10a8f4;
-            border-radius: 3px;
-        }
-        QMenu::item {
-            border: 5px solid transparent;
-        }
-        QMenu::item:selected {
-            margin-left: 3px;
-        }
-        QMenu::separator {
-            height: 1px;
-            background: #303349;
-            margin-left: 15px;
-            margin-right: 10px;
-        }
-        QMenu::indicator {
-            width: 1px;
-            height: 1px;
-        }
-)";
-    fileMenu->setStyleSheet(style);
-    //editMenu->setStyleSheet(style);
-    runMenu->setStyleSheet(style);
-    helpMenu->setStyleSheet(style);
+    // ألوان القوائم من لوحة الألوان، وحدودها وفواصلها يرسمها نمط البرنامج (SPProxyStyle)
 
 
     connect(newAction, &QAction::triggered, this, &SPMenuBar::onNewAction);
     connect(openAction, &QAction::triggered, this, &SPMenuBar::onOpenAction);
+    connect(folderAction, &QAction::triggered, this, &SPMenuBar::onOpenFolderAction);
+    connect(quickOpenAction, &QAction::triggered, this, &SPMenuBar::onQuickOpenAction);
     connect(saveAction, &QAction::triggered, this, &SPMenuBar::onSaveAction);
     connect(saveAsAction, &QAction::triggered, this, &SPMenuBar::onSaveAsAction);
     connect(SettingsAction, &QAction::triggered, this, &SPMenuBar::onSettingsAction);
     connect(exitAction, &QAction::triggered, this, &SPMenuBar::onExitApp);
 
+    connect(projectSearchAction, &QAction::triggered, this, &SPMenuBar::onProjectSearchAction);
+
+    connect(instrumentationAction, &QAction::triggered, this, &SPMenuBar::onInstrumentationAction);
+    connect(frameHudAction, &QAction::triggered, this, &SPMenuBar::onFrameHudAction);
+    connect(traceAction, &QAction::triggered, this, &SPMenuBar::onTraceAction);
+    connect(compareSavedAction, &QAction::triggered, this, &SPMenuBar::onCompareSavedAction);
+    connect(compareFileAction, &QAction::triggered, this, &SPMenuBar::onCompareFileAction);
+
     connect(runAction, &QAction::triggered, this, &SPMenuBar::onRunAction);
 
     connect(aboutAction, &QAction::triggered, this, &SPMenuBar::onAboutAction);
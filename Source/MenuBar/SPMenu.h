@@ -17,6 +17,14 @@ public:
 signals:
     void newRequested();
     void openRequested();
+    void openFolderRequested();
+    void quickOpenRequested();
+    void projectSearchRequested();
+    void instrumentationRequested();
+    void frameHudRequested();
+    void traceRequested();
+    void compareSavedRequested();
+    void compareFileRequested();
     void saveRequested();
     void saveAsRequested();
     void settingsRequest();
@@ -31,6 +39,30 @@ private slots:
     void onOpenAction() {
         emit openRequested();
     }
+    void onOpenFolderAction() {
+        emit openFolderRequested();
+    }
+    void onQuickOpenAction() {
+        emit quickOpenRequested();
+    }
+    void onProjectSearchAction() {
+        emit projectSearchRequested();
+    }
+    void onInstrumentationAction() {
+        emit instrumentationRequested();
+    }
+    void onFrameHudAction() {
+        emit frameHudRequested();
+    }
+    void onTraceAction() {
+        emit traceRequested();
+    }
+    void onCompareSavedAction() {
+        emit compareSavedRequested();
+    }
+    void onCompareFileAction() {
+        emit compareFileRequested();
+    }
     void onSaveAction() {
         emit saveRequested();
     }
@@ -0,0 +1,174 @@
+#include "SPFileCache.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+
+namespace {
+
+struct FileStamp {
+    qint64 size{ -1 };
+    qint64 mtime{};
+};
+
+FileStamp statFile(const QString& path) {
+#if defined(Q_OS_UNIX)
+    struct stat info{};
+    if (::stat(QFile::encodeName(path).constData(), &info) != 0 or !S_ISREG(info.st_mode)) {
+        return {};
+    }
+#if defined(Q_OS_MACOS)
+    return { qint64(info.st_size), qint64(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec };
+#else
+    return { qint64(info.st_size), qint64(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec };
+#endif
+#else
+    QFileInfo info(path);
+    if (!info.isFile()) return {};
+    return { info.size(), info.lastModified().toMSecsSinceEpoch() * 1000000 };
+#endif
+}
+
+} // namespace
+
+
+SPFileCache& SPFileCache::instance() {
+    static SPFileCache cache{};
+    return cache;
+}
+
+SPFileBufferPtr SPFileCache::read(const QString& path, qint64 maxSize) {
+    FileStamp stamp = statFile(path);
+    if (stamp.size < 0) return {};
+    if (maxSize >= 0 and stamp.size > maxSize) return {};
+
+    {
+        QMutexLocker locker(&mutex);
+        auto it = entries.find(path);
+        if (it != entries.end()) {
+            const SPFileBufferPtr& buffer = it->buffer;
+            if (buffer->size() == stamp.size and buffer->modifiedNs() == stamp.mtime) {
+                order.splice(order.begin(), order, it->position);
+                ++counters.hits;
+                counters.bytesSaved += buffer->size();
+                return buffer;
+            }
+            removeEntry(it);
+        }
+        ++counters.misses;
+    }
+
+    // القراءة تتم خارج القفل لكي لا تنتظر الخيوط الأخرى القرص
+    SPFileBufferPtr buffer = load(path, maxSize);
+    if (!buffer) return {};
+
+    QMutexLocker locker(&mutex);
+    // الملفات الكبيرة جداً لا تخزن لكي لا يخرج ملف واحد كل ما سواه
+    if (buffer->size() > limit / 8) return buffer;
+
+    auto it = entries.find(path);
+    if (it != entries.end()) {
+        removeEntry(it);
+    }
+    order.push_front(path);
+    entries.insert(path, { buffer, order.begin() });
+    counters.bytesUsed += buffer->size();
+    evict();
+    return buffer;
+}
+
+void SPFileCache::invalidate(const QString& path) {
+    QMutexLocker locker(&mutex);
+    auto it = entries.find(path);
+    if (it != entries.end()) {
+        removeEntry(it);
+    }
+}
+
+void SPFileCache::clear() {
+    QMutexLocker locker(&mutex);
+    entries.clear();
+    order.clear();
+    counters.bytesUsed = 0;
+}
+
+void SPFileCache::setBudget(qint64 bytes) {
+    QMutexLocker locker(&mutex);
+    limit = qMax<qint64>(0, bytes);
+    evict();
+}
+
+qint64 SPFileCache::budget() const {
+    QMutexLocker locker(&mutex);
+    return limit;
+}
+
+SPFileCache::Stats SPFileCache::stats() const {
+    QMutexLocker locker(&mutex);
+    Stats result = counters;
+    result.budget = limit;
+    result.entries = int(entries.size());
+    return result;
+}
+
+SPFileBufferPtr SPFileCache::load(const QString& path, qint64 maxSize) {
+    QSharedPointer<SPFileBuffer> buffer(new SPFileBuffer());
+
+#if defined(Q_OS_UNIX)
+    // الحجم ووقت التعديل من نفس الوصف الذي يقرأ منه، فلا يختلطان بنسخة أحدث من الملف
+    int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return {};
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 or !S_ISREG(info.st_mode)
+        or (maxSize >= 0 and qint64(info.st_size) > maxSize)) {
+        ::close(fd);
+        return {};
+    }
+#if defined(Q_OS_MACOS)
+    buffer->mtime = qint64(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    buffer->mtime = qint64(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+
+    // القراءة حتى نهاية الملف الفعلية، فالملف الذي يكتب الآن يعطي ما وصل إليه دون خطأ
+    QFile file{};
+    if (!file.open(fd, QIODevice::ReadOnly, QFileDevice::AutoCloseHandle)) {
+        ::close(fd);
+        return {};
+    }
+    buffer->bytes = file.readAll();
+    buffer->length = buffer->bytes.size();
+#else
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return {};
+    if (maxSize >= 0 and file.size() > maxSize) return {};
+
+    buffer->mtime = statFile(path).mtime;
+    buffer->bytes = file.readAll();
+    buffer->length = buffer->bytes.size();
+#endif
+
+    return buffer;
+}
+
+void SPFileCache::removeEntry(QHash<QString, Entry>::iterator it) {
+    counters.bytesUsed -= it->buffer->size();
+    order.erase(it->position);
+    entries.erase(it);
+}
+
+void SPFileCache::evict() {
+    while (counters.bytesUsed > limit and !order.empty()) {
+        auto it = entries.find(order.back());
+        removeEntry(it);
+        ++counters.evictions;
+    }
+}
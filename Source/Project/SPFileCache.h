@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+
+#include <list>
+
+
+// نسخة من محتوى ملف للقراءة فقط مقروءة إلى QByteArray يملكها المخزن
+// لا يربط الملف بالذاكرة، لأن الحفظ والاستبدال والمحررات الأخرى تعيد كتابة الملفات في مكانها
+// فيتغير المحتوى تحت القارئ أو يقرأ بعد نهاية الملف الجديدة
+// يبقى صالحاً ما دام هناك من يحمل مؤشراً إليه حتى لو أخرج من الذاكرة المؤقتة
+class SPFileBuffer {
+public:
+    const char* data() const { return bytes.constData(); }
+    qsizetype size() const { return length; }
+    QByteArrayView view() const { return QByteArrayView(data(), length); }
+
+    qint64 modifiedNs() const { return mtime; }
+
+private:
+    friend class SPFileCache;
+    SPFileBuffer() = default;
+    SPFileBuffer(const SPFileBuffer&) = delete;
+    SPFileBuffer& operator=(const SPFileBuffer&) = delete;
+
+    QByteArray bytes{};
+    qsizetype length{};
+    qint64 mtime{};
+};
+
+using SPFileBufferPtr = QSharedPointer<const SPFileBuffer>;
+
+
+// ذاكرة مؤقتة مشتركة لمحتوى ملفات المشروع على مستوى البرنامج كاملاً
+// المفتاح هو المسار مع وقت التعديل والحجم، فالملف الذي تغير على القرص يقرأ من جديد
+// الحجم الكلي محدود بميزانية، والأقدم استخداماً يخرج أولاً
+// آمنة للاستخدام من أي خيط
+class SPFileCache {
+public:
+    static SPFileCache& instance();
+
+    // يرجع مؤشراً فارغاً إذا تعذرت القراءة أو كان الملف أكبر من maxSize
+    SPFileBufferPtr read(const QString& path, qint64 maxSize = -1);
+    void invalidate(const QString& path);
+    void clear();
+
+    void setBudget(qint64 bytes);
+    qint64 budget() const;
+
+    struct Stats {
+        quint64 hits{};
+        quint64 misses{};
+        quint64 evictions{};
+        qint64 bytesSaved{};    // بايتات قدمت من الذاكرة بدلاً من القرص
+        qint64 bytesUsed{};
+        qint64 budget{};
+        int entries{};
+    };
+    Stats stats() const;
+
+    static constexpr qint64 defaultBudget = 128 * 1024 * 1024;
+
+private:
+    SPFileCache() = default;
+
+    struct Entry {
+        SPFileBufferPtr buffer{};
+        std::list<QString>::iterator position{};
+    };
+
+    static SPFileBufferPtr load(const QString& path, qint64 maxSize);
+    void removeEntry(QHash<QString, Entry>::iterator it);
+    void evict();
+
+    mutable QMutex mutex{};
+    QHash<QString, Entry> entries{};
+    std::list<QString> order{};     // الأحدث استخداماً في البداية
+    qint64 limit{ defaultBudget };
+    Stats counters{};
+};
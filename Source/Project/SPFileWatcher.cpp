@@ -0,0 +1,342 @@
+#include "SPFileWatcher.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
+#include <QFile>
+#include <QElapsedTimer>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#include <poll.h>
+#include <cerrno>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#endif
+
+
+#if defined(Q_OS_LINUX)
+
+// خيط المراقبة ينتظر على inotify و eventfd معاً، و eventfd يوقظه عند تغيير الجدول أو الإيقاف
+class SPWatcherThread : public QThread {
+public:
+    explicit SPWatcherThread(SPFileWatcher* watcher) : watcher(watcher) {
+        inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+
+    ~SPWatcherThread() {
+        setPolled({});
+        if (inotifyFd >= 0) ::close(inotifyFd);
+        if (wakeFd >= 0) ::close(wakeFd);
+    }
+
+    bool isValid() const { return inotifyFd >= 0 and wakeFd >= 0; }
+
+    void setTable(const SPPathTablePtr& table) {
+        {
+            QMutexLocker locker(&mutex);
+            pendingTable = table;
+            tableChanged = true;
+        }
+        wake();
+    }
+
+    void stop() {
+        requestInterruption();
+        wake();
+        wait();
+    }
+
+protected:
+    void run() override {
+        QElapsedTimer firstEvent{};
+        QElapsedTimer lastEvent{};
+        QElapsedTimer lastPoll{};
+
+        while (!isInterruptionRequested()) {
+            // المهلة تحسب من آخر حدث ومن أول حدث في الدفعة الحالية
+            int timeout = -1;
+            if (firstEvent.isValid()) {
+                qint64 quiet = SPFileWatcher::quietMs - lastEvent.elapsed();
+                qint64 limit = SPFileWatcher::maxDelayMs - firstEvent.elapsed();
+                timeout = int(qMax<qint64>(0, qMin(quiet, limit)));
+            }
+            if (!polled.isEmpty()) {
+                if (!lastPoll.isValid()) lastPoll.start();
+                int pollWait = int(qMax<qint64>(0, SPFileWatcher::pollIntervalMs - lastPoll.elapsed()));
+                timeout = timeout < 0 ? pollWait : qMin(timeout, pollWait);
+            }
+
+            pollfd fds[2]{ { inotifyFd, POLLIN, 0 }, { wakeFd, POLLIN, 0 } };
+            int ready = ::poll(fds, 2, timeout);
+            if (ready < 0 and errno != EINTR) break;
+
+            if (fds[1].revents & POLLIN) {
+                quint64 value{};
+                [[maybe_unused]] ssize_t bytes = ::read(wakeFd, &value, sizeof(value));
+                applyTable();
+            }
+
+            bool changed = fds[0].revents & POLLIN and readEvents();
+            if (!polled.isEmpty() and lastPoll.elapsed() >= SPFileWatcher::pollIntervalMs) {
+                changed = pollDirs() or changed;
+                lastPoll.start();
+            }
+            if (changed) {
+                if (!firstEvent.isValid()) firstEvent.start();
+                lastEvent.start();
+            }
+
+            if (firstEvent.isValid() and (lastEvent.elapsed() >= SPFileWatcher::quietMs
+                                          or firstEvent.elapsed() >= SPFileWatcher::maxDelayMs)) {
+                flush();
+                firstEvent.invalidate();
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t watchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE
+                                        | IN_DELETE_SELF | IN_ONLYDIR | IN_DONTFOLLOW | IN_EXCL_UNLINK;
+
+    void wake() {
+        quint64 value = 1;
+        [[maybe_unused]] ssize_t bytes = ::write(wakeFd, &value, sizeof(value));
+    }
+
+    // يطابق المراقبات مع مجلدات الجدول الجديد: يزيل ما لم يعد موجوداً ويضيف الجديد فقط
+    void applyTable() {
+        SPPathTablePtr table{};
+        {
+            QMutexLocker locker(&mutex);
+            if (!tableChanged) return;
+            table = pendingTable;
+            pendingTable.reset();
+            tableChanged = false;
+        }
+
+        QString newRoot = table ? table->rootPath() : QString();
+        if (newRoot != root) {
+            for (auto it = wdToDir.cbegin(); it != wdToDir.cend(); ++it) {
+                ::inotify_rm_watch(inotifyFd, it.key());
+            }
+            wdToDir.clear();
+            dirToWd.clear();
+            dirtyDirs.clear();
+            modifiedFiles.clear();
+            overflow = false;
+            limitReached = false;
+            setPolled({});
+            root = newRoot;
+        }
+        if (!table) {
+            setPolled({});
+            return;
+        }
+
+        QSet<QString> wanted{};
+        wanted.reserve(table->dirCount());
+        for (int dir = 0; dir < table->dirCount(); ++dir) {
+            wanted.insert(table->dirPath(dir).toString());
+        }
+
+        for (auto it = dirToWd.begin(); it != dirToWd.end();) {
+            if (wanted.contains(it.key())) {
+                ++it;
+                continue;
+            }
+            ::inotify_rm_watch(inotifyFd, it.value());
+            wdToDir.remove(it.value());
+            it = dirToWd.erase(it);
+        }
+
+        for (const QString& relDir : std::as_const(wanted)) {
+            if (dirToWd.contains(relDir) or limitReached) continue;
+
+            QString absDir = relDir.isEmpty() ? root : root + '/' + relDir;
+            int wd = ::inotify_add_watch(inotifyFd, QFile::encodeName(absDir).constData(), watchMask);
+            if (wd < 0) {
+                // تجاوز حد fs.inotify.max_user_watches، والمجلدات الباقية تبقى بدون مراقبة
+                if (errno == ENOSPC) {
+                    limitReached = true;
+                    qWarning("SPFileWatcher: inotify watch limit reached, project is only partially watched");
+                }
+                continue;
+            }
+            // inotify يرجع نفس الرقم لنفس المجلد، فقد يكون المسار القديم لمجلد أعيدت تسميته
+            QString previous = wdToDir.value(wd);
+            if (!previous.isNull()) {
+                dirToWd.remove(previous);
+            }
+            wdToDir.insert(wd, relDir);
+            dirToWd.insert(relDir, wd);
+        }
+
+        // المجلدات التي لم تجد مراقبة تفحص دورياً، ووقت تعديلها الأول يؤخذ عند دخولها القائمة
+        QHash<QString, qint64> unwatched{};
+        if (limitReached) {
+            for (const QString& relDir : std::as_const(wanted)) {
+                if (dirToWd.contains(relDir)) continue;
+                auto it = polled.constFind(relDir);
+                unwatched.insert(relDir, it != polled.cend() ? it.value() : modifiedTime(relDir));
+            }
+        }
+        bool newlyLimited = polled.isEmpty() and !unwatched.isEmpty();
+        setPolled(unwatched);
+
+        if (newlyLimited) {
+            qWarning("SPFileWatcher: inotify watch limit reached, polling %d directories", int(polled.size()));
+            SPFileWatcher* target = watcher;
+            int count = int(polled.size());
+            QMetaObject::invokeMethod(target, [target, count]() {
+                emit target->watchLimitReached(count);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    void setPolled(const QHash<QString, qint64>& dirs) {
+        SPFileWatcher::polledDirs.fetch_add(int(dirs.size() - polled.size()), std::memory_order_relaxed);
+        polled = dirs;
+    }
+
+    // وقت تعديل المجلد يتغير عند إضافة أو حذف أو إعادة تسمية ما فيه، و-1 إن لم يعد موجوداً
+    qint64 modifiedTime(const QString& relDir) const {
+        QString absDir = relDir.isEmpty() ? root : root + '/' + relDir;
+        struct stat info{};
+        if (::stat(QFile::encodeName(absDir).constData(), &info) != 0) return -1;
+        return qint64(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+    }
+
+    bool pollDirs() {
+        bool any = false;
+        for (auto it = polled.begin(); it != polled.end(); ++it) {
+            qint64 mtime = modifiedTime(it.key());
+            if (mtime == it.value()) continue;
+            it.value() = mtime;
+            dirtyDirs.insert(it.key());
+            any = true;
+        }
+        return any;
+    }
+
+    bool readEvents() {
+        alignas(inotify_event) char buffer[64 * 1024];
+        bool any = false;
+
+        for (;;) {
+            ssize_t bytes = ::read(inotifyFd, buffer, sizeof(buffer));
+            if (bytes <= 0) break;
+
+            for (ssize_t offset = 0; offset < bytes;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += qsizetype(sizeof(inotify_event)) + event->len;
+                any = true;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    overflow = true;
+                    continue;
+                }
+
+                auto it = wdToDir.constFind(event->wd);
+                if (it == wdToDir.constEnd()) continue;
+                QString relDir = it.value();
+
+                if (event->mask & IN_IGNORED) {
+                    // أزيلت المراقبة لأن المجلد حذف، وإعادة فحص أبيه تحذفه من الجدول
+                    dirToWd.remove(relDir);
+                    wdToDir.remove(event->wd);
+                    if (!relDir.isEmpty()) {
+                        qsizetype slash = relDir.lastIndexOf('/');
+                        dirtyDirs.insert(slash == -1 ? QString() : relDir.left(slash));
+                    }
+                    continue;
+                }
+                if (event->mask & IN_DELETE_SELF) continue;
+
+                QString name = event->len > 0 ? QFile::decodeName(event->name) : QString();
+                if (event->mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)) {
+                    dirtyDirs.insert(relDir);
+                }
+                else if (event->mask & IN_CLOSE_WRITE and !name.isEmpty()) {
+                    modifiedFiles.insert(relDir.isEmpty() ? name : relDir + '/' + name);
+                }
+            }
+        }
+        return any;
+    }
+
+    void flush() {
+        // الأحداث الضائعة قد تخص أي مجلد مراقب، فتعاد قراءتها كلها دون أبنائها بدلاً من فحص المشروع كاملاً
+        if (overflow) {
+            for (auto it = dirToWd.cbegin(); it != dirToWd.cend(); ++it) {
+                dirtyDirs.insert(it.key());
+            }
+            overflow = false;
+        }
+        if (dirtyDirs.isEmpty() and modifiedFiles.isEmpty()) return;
+
+        QStringList dirs(dirtyDirs.cbegin(), dirtyDirs.cend());
+        QStringList modified(modifiedFiles.cbegin(), modifiedFiles.cend());
+        dirtyDirs.clear();
+        modifiedFiles.clear();
+
+        SPFileWatcher* target = watcher;
+        QMetaObject::invokeMethod(target, [target, dirs, modified]() {
+            emit target->changesDetected(dirs, modified);
+        }, Qt::QueuedConnection);
+    }
+
+    SPFileWatcher* watcher{};
+    int inotifyFd{ -1 };
+    int wakeFd{ -1 };
+
+    QMutex mutex{};
+    SPPathTablePtr pendingTable{};
+    bool tableChanged{};
+
+    // الحالة التالية يستخدمها خيط المراقبة وحده
+    QString root{};
+    QHash<int, QString> wdToDir{};
+    QHash<QString, int> dirToWd{};
+    QSet<QString> dirtyDirs{};
+    QSet<QString> modifiedFiles{};
+    bool overflow{};
+    bool limitReached{};
+    // المجلدات بدون مراقبة بعد نفاد الحد ← آخر وقت تعديل معروف
+    QHash<QString, qint64> polled{};
+};
+
+#else
+
+class SPWatcherThread : public QThread {
+public:
+    explicit SPWatcherThread(SPFileWatcher*) {}
+    bool isValid() const { return false; }
+    void setTable(const SPPathTablePtr&) {}
+    void stop() {}
+};
+
+#endif
+
+
+SPFileWatcher::SPFileWatcher(QObject* parent) : QObject(parent) {
+    thread = new SPWatcherThread(this);
+    if (thread->isValid()) {
+        thread->start(QThread::LowPriority);
+    }
+}
+
+SPFileWatcher::~SPFileWatcher() {
+    if (thread->isRunning()) {
+        thread->stop();
+    }
+    delete thread;
+}
+
+void SPFileWatcher::watch(const SPPathTablePtr& table) {
+    if (!thread->isRunning()) return;
+    thread->setTable(table);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "SPProjectIndex.h"
+
+#include <QObject>
+#include <QStringList>
+
+#include <atomic>
+
+class SPWatcherThread;
+
+
+// يراقب مجلدات المشروع ويجمع أحداث نظام الملفات المتقاربة في دفعة واحدة
+// الدفعة تصدر بعد هدوء الأحداث لمدة قصيرة أو بعد مدة قصوى أثناء التغييرات المستمرة
+// على لينكس يستخدم inotify في خيط مستقل، وعلى بقية الأنظمة لا يراقب شيئاً حالياً
+// إذا نفد حد المراقبات فالمجلدات الباقية تفحص دورياً بوقت تعديلها بدلاً من الأحداث
+class SPFileWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SPFileWatcher(QObject* parent = nullptr);
+    ~SPFileWatcher();
+
+    // يراقب كل مجلدات الجدول، والجدول الفارغ يوقف المراقبة
+    void watch(const SPPathTablePtr& table);
+
+    // عدد المجلدات المفحوصة دورياً في كل المراقبين، ويظهر في لوحة الأداء
+    static int polledDirCount() { return polledDirs.load(std::memory_order_relaxed); }
+
+    static constexpr int quietMs = 100;
+    static constexpr int maxDelayMs = 1000;
+    static constexpr int pollIntervalMs = 5000;
+
+signals:
+    // dirtyDirs: مجلدات أضيف إليها أو حذف منها شيء، بمسارها النسبي
+    // modifiedFiles: ملفات تغير محتواها
+    // إذا فاضت قائمة أحداث inotify فكل المجلدات المراقبة تعد متغيرة، وتعديلات المحتوى الضائعة لا تعرف
+    void changesDetected(const QStringList& dirtyDirs, const QStringList& modifiedFiles);
+    // نفد حد fs.inotify.max_user_watches وبقيت polledDirs مجلداً بدون مراقبة
+    void watchLimitReached(int polledDirs);
+
+private:
+    friend class SPWatcherThread;
+
+    SPWatcherThread* thread{};
+    static inline std::atomic_int polledDirs{};
+};
@@ -0,0 +1,138 @@
+#include "SPIgnoreRules.h"
+
+#include <QFile>
+#include <QSet>
+
+
+QSharedPointer<const SPIgnoreRules> SPIgnoreRules::load(const QString& absDir, const QString& relDir,
+                                                        bool hasGitIgnore, bool hasSpectrumIgnore,
+                                                        const QSharedPointer<const SPIgnoreRules>& parent) {
+    if (!hasGitIgnore and !hasSpectrumIgnore) {
+        return parent;
+    }
+
+    QSharedPointer<SPIgnoreRules> rules(new SPIgnoreRules);
+    rules->parent = parent;
+    rules->base = relDir;
+
+    // قواعد .spectrumignore تقرأ بعد .gitignore لكي تكون لها الأولوية
+    const QStringList fileNames = { ".gitignore", ".spectrumignore" };
+    const bool present[] = { hasGitIgnore, hasSpectrumIgnore };
+    for (int i = 0; i < fileNames.size(); ++i) {
+        if (!present[i]) continue;
+        QFile file(absDir + '/' + fileNames.at(i));
+        if (file.open(QIODevice::ReadOnly)) {
+            rules->parse(file.readAll());
+        }
+    }
+
+    if (rules->patterns.isEmpty()) {
+        return parent;
+    }
+    return rules;
+}
+
+void SPIgnoreRules::parse(const QByteArray& content) {
+    const QList<QByteArray> lines = content.split('\n');
+    for (const QByteArray& rawLine : lines) {
+        QString line = QString::fromUtf8(rawLine);
+        if (line.endsWith('\r')) line.chop(1);
+
+        // remove trailing spaces unless escaped
+        while (line.endsWith(' ') and !line.endsWith("\\ ")) line.chop(1);
+        if (line.isEmpty() or line.startsWith('#')) continue;
+
+        Pattern pattern{};
+        if (line.startsWith('!')) {
+            pattern.negate = true;
+            line.remove(0, 1);
+        }
+        if (line.endsWith('/')) {
+            pattern.dirOnly = true;
+            line.chop(1);
+        }
+        if (line.isEmpty()) continue;
+
+        // النمط الذي لا يحتوي على '/' يطابق الاسم في أي عمق
+        // أما النمط الذي يحتويها فيطابق المسار نسبةً إلى مجلد ملف التجاهل
+        QString regex{};
+        if (line.contains('/')) {
+            if (line.startsWith('/')) line.remove(0, 1);
+            regex = "^" + globToRegex(line) + "$";
+        } else {
+            regex = "(?:^|/)" + globToRegex(line) + "$";
+        }
+
+        pattern.regex = QRegularExpression(regex);
+        if (pattern.regex.isValid()) {
+            pattern.regex.optimize();
+            patterns.append(pattern);
+        }
+    }
+}
+
+QString SPIgnoreRules::globToRegex(const QString& glob) {
+    QString regex{};
+    qsizetype i = 0;
+    while (i < glob.length()) {
+        QChar ch = glob.at(i);
+        if (ch == '*') {
+            if (i + 1 < glob.length() and glob.at(i + 1) == '*') {
+                i += 2;
+                if (i < glob.length() and glob.at(i) == '/') {
+                    regex += "(?:.*/)?"; // "**/" تطابق صفر أو أكثر من المجلدات
+                    ++i;
+                } else {
+                    regex += ".*";
+                }
+                continue;
+            }
+            regex += "[^/]*";
+        }
+        else if (ch == '?') {
+            regex += "[^/]";
+        }
+        else if (ch == '[') {
+            qsizetype end = glob.indexOf(']', i + 1);
+            if (end == -1) {
+                regex += "\\[";
+            } else {
+                QString set = glob.mid(i + 1, end - i - 1);
+                if (set.startsWith('!')) set[0] = '^';
+                regex += "[" + set.replace("\\", "\\\\") + "]";
+                i = end;
+            }
+        }
+        else if (ch == '\\' and i + 1 < glob.length()) {
+            ++i;
+            regex += QRegularExpression::escape(QString(glob.at(i)));
+        }
+        else {
+            regex += QRegularExpression::escape(QString(ch));
+        }
+        ++i;
+    }
+    return regex;
+}
+
+bool SPIgnoreRules::isIgnored(const QString& relPath, bool isDir) const {
+    // آخر قاعدة مطابقة هي التي تحدد النتيجة، وقواعد المجلد الأقرب تسبق قواعد الأب
+    for (const SPIgnoreRules* rules = this; rules; rules = rules->parent.data()) {
+        QString local = rules->base.isEmpty() ? relPath : relPath.mid(rules->base.length() + 1);
+        for (qsizetype i = rules->patterns.size() - 1; i >= 0; --i) {
+            const Pattern& pattern = rules->patterns.at(i);
+            if (pattern.dirOnly and !isDir) continue;
+            if (pattern.regex.match(local).hasMatch()) {
+                return !pattern.negate;
+            }
+        }
+    }
+    return false;
+}
+
+bool SPIgnoreRules::isHeavyDirectory(const QString& dirName) {
+    static const QSet<QString> heavyDirs = { ".git", ".svn", ".hg", ".cache", ".idea", ".vs",
+        ".vscode", "node_modules", "__pycache__", "build", "dist", "out" };
+
+    return heavyDirs.contains(dirName) or dirName.startsWith("build-");
+}
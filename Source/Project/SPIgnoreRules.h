@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QRegularExpression>
+#include <QSharedPointer>
+
+
+// قواعد التجاهل الخاصة بمجلد واحد كما في .gitignore و .spectrumignore
+// كل مجلد يحمل قواعده ويرث قواعد المجلد الأب
+class SPIgnoreRules {
+public:
+    // يقرأ ملفات التجاهل الموجودة في المجلد، ويرجع قواعد الأب نفسها إذا لم توجد ملفات
+    static QSharedPointer<const SPIgnoreRules> load(const QString& absDir, const QString& relDir,
+                                                    bool hasGitIgnore, bool hasSpectrumIgnore,
+                                                    const QSharedPointer<const SPIgnoreRules>& parent);
+
+    // relPath مسار العنصر نسبةً إلى جذر المشروع
+    bool isIgnored(const QString& relPath, bool isDir) const;
+
+    // مجلدات ثقيلة يتم تجاهلها دائماً مهما كانت القواعد
+    static bool isHeavyDirectory(const QString& dirName);
+
+private:
+    struct Pattern {
+        QRegularExpression regex{};
+        bool negate{};
+        bool dirOnly{};
+    };
+
+    void parse(const QByteArray& content);
+    static QString globToRegex(const QString& glob);
+
+    QSharedPointer<const SPIgnoreRules> parent{};
+    QString base{};
+    QList<Pattern> patterns{};
+};
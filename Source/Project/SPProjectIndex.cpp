@@ -0,0 +1,575 @@
+#include "SPProjectIndex.h"
+#include "SPFileWatcher.h"
+#include "SPTrace.h"
+
+#include <QFile>
+#include <QDir>
+#include <QDirIterator>
+#include <QMap>
+#include <QFileInfo>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#endif
+
+
+/* ---------------------------------- Path Table ---------------------------------- */
+
+SPPathTable::SPPathTable(const QString& rootPath) : root(rootPath) {
+}
+
+QStringView SPPathTable::fileName(int file) const {
+    const File& entry = files.at(file);
+    return QStringView(pool).mid(entry.offset, entry.length);
+}
+
+QStringView SPPathTable::dirPath(int dir) const {
+    const Dir& entry = dirs.at(dir);
+    return QStringView(pool).mid(entry.offset, entry.length);
+}
+
+QString SPPathTable::relativePath(int file) const {
+    QStringView dir = dirPath(fileDir(file));
+    QStringView name = fileName(file);
+    if (dir.isEmpty()) {
+        return name.toString();
+    }
+
+    QString path{};
+    path.reserve(dir.size() + 1 + name.size());
+    path.append(dir);
+    path.append('/');
+    path.append(name);
+    return path;
+}
+
+QString SPPathTable::absolutePath(int file) const {
+    return root + '/' + relativePath(file);
+}
+
+qsizetype SPPathTable::memoryUsage() const {
+    return pool.capacity() * qsizetype(sizeof(QChar))
+         + dirs.capacity() * qsizetype(sizeof(Dir))
+         + files.capacity() * qsizetype(sizeof(File))
+         + rules.capacity() * qsizetype(sizeof(QSharedPointer<const SPIgnoreRules>));
+}
+
+int SPPathTable::addDir(int parent, QStringView relPath, const QSharedPointer<const SPIgnoreRules>& dirRules) {
+    qint32 offset = intern(relPath);
+    dirs.append({ parent, offset, qint32(relPath.length()) });
+    rules.append(dirRules);
+    return int(dirs.size() - 1);
+}
+
+int SPPathTable::addFile(int dir, QStringView name) {
+    qint32 offset = intern(name);
+    files.append({ dir, offset, qint32(name.length()) });
+    return int(files.size() - 1);
+}
+
+qint32 SPPathTable::intern(QStringView text) {
+    // الأسماء المتكررة مثل _تهيئة_.aliflib تخزن مرة واحدة فقط
+    QString key = text.toString();
+    auto it = internIndex.constFind(key);
+    if (it != internIndex.constEnd()) {
+        return it.value();
+    }
+    qint32 offset = qint32(pool.size());
+    pool.append(text);
+    internIndex.insert(key, offset);
+    return offset;
+}
+
+void SPPathTable::finish() {
+    internIndex.clear();
+    internIndex.squeeze();
+    pool.squeeze();
+    dirs.squeeze();
+    files.squeeze();
+    rules.squeeze();
+}
+
+
+/* ---------------------------------- Crawler ---------------------------------- */
+
+namespace {
+
+struct DirEntry {
+    QString name{};
+    bool isDir{};
+};
+
+struct CrawlJob {
+    QString relDir{};
+    QSharedPointer<const SPIgnoreRules> rules{};
+    bool recursive{ true };
+};
+
+struct CrawlResult {
+    QString relDir{};
+    bool exists{};
+    QStringList files{};
+    QStringList subdirs{};
+    QSharedPointer<const SPIgnoreRules> rules{};
+};
+
+#if defined(Q_OS_LINUX)
+struct LinuxDirent64 {
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+#endif
+
+// يقرأ محتوى المجلد دفعة واحدة، وعلى لينكس يستخدم getdents64 مباشرة
+// لقراءة مئات المدخلات في كل استدعاء بدون stat لكل ملف
+bool readDirectory(const QString& absDir, QList<DirEntry>& entries) {
+#if defined(Q_OS_LINUX)
+    int fd = ::open(QFile::encodeName(absDir).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    alignas(8) char buffer[32 * 1024];
+    for (;;) {
+        long bytes = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+        if (bytes <= 0) break;
+
+        for (long offset = 0; offset < bytes;) {
+            const LinuxDirent64* entry = reinterpret_cast<const LinuxDirent64*>(buffer + offset);
+            offset += entry->d_reclen;
+
+            const char* name = entry->d_name;
+            if (name[0] == '.' and (name[1] == '\0' or (name[1] == '.' and name[2] == '\0'))) {
+                continue;
+            }
+
+            unsigned char type = entry->d_type;
+            if (type == DT_UNKNOWN or type == DT_LNK) {
+                struct stat info{};
+                if (::fstatat(fd, name, &info, type == DT_LNK ? 0 : AT_SYMLINK_NOFOLLOW) != 0) {
+                    continue;
+                }
+                // لا يتم تتبع الروابط الرمزية للمجلدات لتجنب الحلقات
+                if (S_ISDIR(info.st_mode) and type != DT_LNK) type = DT_DIR;
+                else if (S_ISREG(info.st_mode)) type = DT_REG;
+                else continue;
+            }
+            if (type != DT_DIR and type != DT_REG) continue;
+
+            entries.append({ QFile::decodeName(name), type == DT_DIR });
+        }
+    }
+
+    ::close(fd);
+    return true;
+#else
+    if (!QFileInfo(absDir).isDir()) {
+        return false;
+    }
+    QDirIterator it(absDir, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo info = it.fileInfo();
+        entries.append({ info.fileName(), info.isDir() });
+    }
+    return true;
+#endif
+}
+
+
+// يزحف على المجلدات بالتوازي، إما على المشروع كاملاً أو على مجلدات محددة فقط
+// في الفحص الجزئي لا ينزل إلى المجلدات الفرعية المعروفة مسبقاً، وإنما إلى الجديدة منها فقط
+class ProjectCrawler {
+public:
+    ProjectCrawler(const QString& root, QSharedPointer<std::atomic_bool> cancelled, SPProjectIndex* index,
+                   const QHash<QString, int>* knownDirs)
+        : root(root), cancelled(cancelled), index(index), knownDirs(knownDirs) {}
+
+    QList<CrawlResult> run(QThreadPool* pool, const QList<CrawlJob>& jobs) {
+        queue = jobs;
+
+        // الخيط الحالي يعمل أيضاً لكي يتقدم الزحف حتى لو كانت بقية خيوط المجموعة مشغولة
+        int helpers = jobs.size() > 1 or jobs.value(0).recursive ? qMax(0, pool->maxThreadCount() - 2) : 0;
+        QList<QList<CrawlResult>> results(helpers + 1);
+        QList<QFuture<void>> futures{};
+        for (int i = 0; i < helpers; ++i) {
+            QList<CrawlResult>* out = &results[i];
+            futures.append(QtConcurrent::run(pool, [this, out]() { work(*out); }));
+        }
+        work(results[helpers]);
+        for (QFuture<void>& future : futures) {
+            future.waitForFinished();
+        }
+
+        QList<CrawlResult> all{};
+        for (QList<CrawlResult>& part : results) {
+            all.append(std::move(part));
+        }
+        return all;
+    }
+
+private:
+    void work(QList<CrawlResult>& results) {
+        SP_TRACE_SCOPE("projectIndex.crawl");
+        for (;;) {
+            CrawlJob job{};
+            {
+                QMutexLocker locker(&mutex);
+                while (queue.isEmpty() and active > 0 and !cancelled->load()) {
+                    wake.wait(&mutex);
+                }
+                if (queue.isEmpty() or cancelled->load()) {
+                    wake.wakeAll();
+                    return;
+                }
+                // السحب من النهاية يجعل الزحف بالعمق أولاً فيبقى الطابور صغيراً
+                job = queue.takeLast();
+                ++active;
+            }
+
+            CrawlResult result{ job.relDir };
+            crawlDirectory(job, result);
+
+            QList<CrawlJob> subdirs{};
+            for (const QString& subdir : std::as_const(result.subdirs)) {
+                if (job.recursive or !knownDirs or !knownDirs->contains(subdir)) {
+                    subdirs.append({ subdir, result.rules, true });
+                }
+            }
+
+            // المجلد يبقى في الجدول حتى لو لم يحتوِ ملفات لأن أبناءه قد يحتوونها
+            int found = int(result.files.size());
+            results.append(std::move(result));
+            reportProgress(found);
+
+            {
+                QMutexLocker locker(&mutex);
+                queue.append(subdirs);
+                --active;
+                wake.wakeAll();
+            }
+        }
+    }
+
+    void crawlDirectory(const CrawlJob& job, CrawlResult& result) {
+        QString absDir = job.relDir.isEmpty() ? root : root + '/' + job.relDir;
+
+        QList<DirEntry> entries{};
+        if (!readDirectory(absDir, entries)) {
+            return;
+        }
+        result.exists = true;
+
+        bool hasGitIgnore = false;
+        bool hasSpectrumIgnore = false;
+        for (const DirEntry& entry : entries) {
+            if (entry.isDir) continue;
+            if (entry.name == ".gitignore") hasGitIgnore = true;
+            else if (entry.name == ".spectrumignore") hasSpectrumIgnore = true;
+        }
+        result.rules = SPIgnoreRules::load(absDir, job.relDir, hasGitIgnore, hasSpectrumIgnore, job.rules);
+
+        for (const DirEntry& entry : entries) {
+            QString relPath = job.relDir.isEmpty() ? entry.name : job.relDir + '/' + entry.name;
+            if (entry.isDir) {
+                if (SPIgnoreRules::isHeavyDirectory(entry.name)) continue;
+                if (result.rules and result.rules->isIgnored(relPath, true)) continue;
+                result.subdirs.append(relPath);
+            }
+            else {
+                if (result.rules and result.rules->isIgnored(relPath, false)) continue;
+                result.files.append(entry.name);
+            }
+        }
+    }
+
+    void reportProgress(int found) {
+        // يتم الإبلاغ كل بضعة آلاف ملف فقط لكي لا تغرق حلقة الأحداث بالإشارات
+        constexpr int step = 4096;
+        int before = filesFound.fetch_add(found);
+        int after = before + found;
+        if (before / step != after / step) {
+            SPProjectIndex* target = index;
+            QMetaObject::invokeMethod(target, [target, after]() {
+                emit target->progress(after);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    QString root{};
+    QSharedPointer<std::atomic_bool> cancelled{};
+    SPProjectIndex* index{};
+    const QHash<QString, int>* knownDirs{};
+
+    QMutex mutex{};
+    QWaitCondition wake{};
+    QList<CrawlJob> queue{};
+    int active{};
+    std::atomic_int filesFound{};
+};
+
+
+QString joinPath(const QString& dir, const QString& name) {
+    return dir.isEmpty() ? name : dir + '/' + name;
+}
+
+// يدمج نتائج الزحف مع الجدول القديم في جدول جديد، ويحسب الملفات المضافة والمحذوفة
+// المجلد الذي أعيد فحص أبيه ولم يظهر بين أبنائه يعتبر محذوفاً مع كل ما تحته
+SPProjectIndex::Update buildUpdate(const QString& root, const SPPathTablePtr& old, QList<CrawlResult>& results) {
+    struct DirData {
+        QStringList files{};
+        QSharedPointer<const SPIgnoreRules> rules{};
+    };
+
+    QHash<QString, const CrawlResult*> scanned{};
+    QSet<QString> foundSubdirs{};
+    QSet<QString> missing{};
+    for (CrawlResult& result : results) {
+        if (!result.exists) {
+            missing.insert(result.relDir);
+            continue;
+        }
+        result.files.sort();
+        scanned.insert(result.relDir, &result);
+        for (const QString& subdir : std::as_const(result.subdirs)) {
+            foundSubdirs.insert(subdir);
+        }
+    }
+
+    QMap<QString, DirData> dirs{};
+    QSet<QString> oldDirs{};
+    SPIndexDelta delta{};
+
+    if (old) {
+        QList<QStringList> oldFiles(old->dirCount());
+        for (int file = 0; file < old->fileCount(); ++file) {
+            oldFiles[old->fileDir(file)].append(old->fileName(file).toString());
+        }
+
+        // الأب يسبق أبناءه في الجدول، لذلك يكفي المرور مرة واحدة لمعرفة الفروع المحذوفة
+        QList<bool> dropped(old->dirCount(), false);
+        for (int dir = 0; dir < old->dirCount(); ++dir) {
+            QString path = old->dirPath(dir).toString();
+            int parent = old->dirParent(dir);
+            bool vanished = missing.contains(path)
+                or (parent >= 0 and dropped.at(parent))
+                or (parent >= 0 and scanned.contains(old->dirPath(parent).toString()) and !foundSubdirs.contains(path));
+
+            if (vanished) {
+                dropped[dir] = true;
+                for (const QString& name : std::as_const(oldFiles.at(dir))) {
+                    delta.removedFiles.append(joinPath(path, name));
+                }
+                continue;
+            }
+            oldDirs.insert(path);
+
+            const CrawlResult* result = scanned.value(path);
+            if (!result) {
+                dirs.insert(path, { oldFiles.at(dir), old->dirRules(dir) });
+                continue;
+            }
+
+            QSet<QString> before(oldFiles.at(dir).cbegin(), oldFiles.at(dir).cend());
+            QSet<QString> after(result->files.cbegin(), result->files.cend());
+            for (const QString& name : result->files) {
+                if (!before.contains(name)) delta.addedFiles.append(joinPath(path, name));
+            }
+            for (const QString& name : std::as_const(oldFiles.at(dir))) {
+                if (!after.contains(name)) delta.removedFiles.append(joinPath(path, name));
+            }
+        }
+    }
+
+    for (auto it = scanned.cbegin(); it != scanned.cend(); ++it) {
+        const CrawlResult* result = it.value();
+        dirs.insert(result->relDir, { result->files, result->rules });
+        if (old and !oldDirs.contains(result->relDir)) {
+            for (const QString& name : result->files) {
+                delta.addedFiles.append(joinPath(result->relDir, name));
+            }
+        }
+    }
+
+    // ترتيب QMap يضع المجلد الأب قبل أبنائه لأن مساره بادئة لمساراتهم
+    QSharedPointer<SPPathTable> table(new SPPathTable(root));
+    QHash<QString, int> dirIndex{};
+    for (auto it = dirs.cbegin(); it != dirs.cend(); ++it) {
+        const QString& path = it.key();
+        int parent = -1;
+        if (!path.isEmpty()) {
+            qsizetype slash = path.lastIndexOf('/');
+            auto parentIt = dirIndex.constFind(slash == -1 ? QString() : path.left(slash));
+            if (parentIt == dirIndex.constEnd()) continue;
+            parent = parentIt.value();
+        }
+
+        int dirId = table->addDir(parent, path, it->rules);
+        dirIndex.insert(path, dirId);
+        for (const QString& name : it->files) {
+            table->addFile(dirId, name);
+        }
+    }
+    table->finish();
+
+    return { table, delta };
+}
+
+} // namespace
+
+
+/* ---------------------------------- Project Index ---------------------------------- */
+
+SPProjectIndex::SPProjectIndex(QObject* parent) : QObject(parent) {
+    crawlPool = new QThreadPool(this);
+    crawlPool->setMaxThreadCount(QThread::idealThreadCount() + 1);
+
+    crawlWatcher = new QFutureWatcher<Update>(this);
+    connect(crawlWatcher, &QFutureWatcher<Update>::finished, this, &SPProjectIndex::onCrawlFinished);
+
+    fileWatcher = new SPFileWatcher(this);
+    connect(fileWatcher, &SPFileWatcher::changesDetected, this, &SPProjectIndex::applyChanges);
+    connect(fileWatcher, &SPFileWatcher::watchLimitReached, this, &SPProjectIndex::watchLimitReached);
+}
+
+SPProjectIndex::~SPProjectIndex() {
+    if (crawlCancelled) {
+        crawlCancelled->store(true);
+    }
+    crawlPool->waitForDone();
+}
+
+void SPProjectIndex::setRootPath(const QString& path) {
+    QString cleanPath = QDir::cleanPath(path);
+    if (cleanPath == root) return;
+
+    root = cleanPath;
+    table.reset();
+    fileWatcher->watch(SPPathTablePtr());
+    rescan();
+}
+
+void SPProjectIndex::rescan() {
+    if (root.isEmpty()) return;
+
+    // الزحف الكامل يغطي أي تغييرات معلقة
+    pendingDirs.clear();
+    pendingModified.clear();
+    startCrawl(false, {});
+}
+
+void SPProjectIndex::applyChanges(const QStringList& dirtyDirs, const QStringList& modifiedFiles) {
+    if (root.isEmpty()) return;
+
+    // لا يبدأ تحديث جديد قبل انتهاء السابق، والتغييرات تتجمع حتى ذلك الحين
+    if (!table or crawlWatcher->isRunning()) {
+        pendingDirs.unite(QSet<QString>(dirtyDirs.cbegin(), dirtyDirs.cend()));
+        pendingModified.unite(QSet<QString>(modifiedFiles.cbegin(), modifiedFiles.cend()));
+        return;
+    }
+
+    // تعديل محتوى الملفات لا يغير الجدول
+    if (dirtyDirs.isEmpty()) {
+        if (!modifiedFiles.isEmpty()) {
+            SPIndexDelta delta{};
+            delta.modifiedFiles = modifiedFiles;
+            emit changed(delta);
+        }
+        return;
+    }
+
+    crawlModified = modifiedFiles;
+    startCrawl(true, dirtyDirs);
+}
+
+void SPProjectIndex::startCrawl(bool incremental, const QStringList& dirtyDirs) {
+    // إلغاء أي زحف سابق، والنتيجة القديمة لن تصل لأن المراقب ينتقل للمستقبل الجديد
+    if (crawlCancelled) {
+        crawlCancelled->store(true);
+    }
+    crawlCancelled = QSharedPointer<std::atomic_bool>::create(false);
+    crawlTimer.start();
+    incrementalCrawl = incremental;
+
+    QThreadPool* pool = crawlPool;
+    SPPathTablePtr old = incremental ? table : SPPathTablePtr();
+    QFuture<Update> future = QtConcurrent::run(pool,
+        [this, pool, old, dirtyDirs, crawlRoot = root, cancelled = crawlCancelled]() -> Update {
+            QHash<QString, int> knownDirs{};
+            QList<CrawlJob> jobs{};
+            if (old) {
+                for (int dir = 0; dir < old->dirCount(); ++dir) {
+                    knownDirs.insert(old->dirPath(dir).toString(), dir);
+                }
+            }
+
+            if (!old) {
+                jobs.append(CrawlJob{});
+            }
+            else {
+                QSet<int> queued{};
+                for (QString dirPath : dirtyDirs) {
+                    // المجلد غير الموجود في الجدول يفحص عبر أقرب أب معروف
+                    while (!knownDirs.contains(dirPath) and !dirPath.isEmpty()) {
+                        qsizetype slash = dirPath.lastIndexOf('/');
+                        dirPath = slash == -1 ? QString() : dirPath.left(slash);
+                    }
+                    int dir = knownDirs.value(dirPath, -1);
+                    if (dir == -1 or queued.contains(dir)) continue;
+                    queued.insert(dir);
+
+                    int parent = old->dirParent(dir);
+                    jobs.append({ dirPath, parent >= 0 ? old->dirRules(parent) : nullptr, false });
+                }
+            }
+
+            ProjectCrawler crawler(crawlRoot, cancelled, this, old ? &knownDirs : nullptr);
+            QList<CrawlResult> results = crawler.run(pool, jobs);
+            if (cancelled->load()) {
+                return {};
+            }
+            return buildUpdate(crawlRoot, old, results);
+        });
+    crawlWatcher->setFuture(future);
+}
+
+void SPProjectIndex::onCrawlFinished() {
+    Update update = crawlWatcher->result();
+    if (!update.table) return;
+
+    table = update.table;
+    fileWatcher->watch(table);
+
+    if (incrementalCrawl) {
+        update.delta.modifiedFiles = crawlModified;
+        if (!update.delta.isEmpty()) {
+            emit changed(update.delta);
+        }
+    }
+    else {
+        emit ready(table->fileCount(), crawlTimer.elapsed());
+    }
+    crawlModified.clear();
+
+    if (!pendingDirs.isEmpty() or !pendingModified.isEmpty()) {
+        QStringList dirs(pendingDirs.cbegin(), pendingDirs.cend());
+        QStringList modified(pendingModified.cbegin(), pendingModified.cend());
+        pendingDirs.clear();
+        pendingModified.clear();
+        applyChanges(dirs, modified);
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "SPIgnoreRules.h"
+
+#include <QObject>
+#include <QString>
+#include <QStringView>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QFutureWatcher>
+#include <QElapsedTimer>
+
+#include <atomic>
+
+class QThreadPool;
+class SPFileWatcher;
+
+
+// جدول مسارات مضغوط لملفات المشروع
+// أسماء الملفات ومسارات المجلدات تخزن مرة واحدة في مخزن نصي مشترك
+// والملف يمثل برقم المجلد وموقع اسمه في المخزن
+class SPPathTable {
+public:
+    explicit SPPathTable(const QString& rootPath = QString());
+
+    QString rootPath() const { return root; }
+    int fileCount() const { return int(files.size()); }
+    int dirCount() const { return int(dirs.size()); }
+
+    QStringView fileName(int file) const;
+    int fileDir(int file) const { return files.at(file).dir; }
+    QString relativePath(int file) const;
+    QString absolutePath(int file) const;
+
+    // مسار المجلد نسبةً إلى الجذر، والجذر نفسه مساره ""
+    QStringView dirPath(int dir) const;
+    int dirParent(int dir) const { return dirs.at(dir).parent; }
+    // قواعد التجاهل السارية داخل المجلد، وتستخدم عند إعادة فحصه وحده
+    QSharedPointer<const SPIgnoreRules> dirRules(int dir) const { return rules.at(dir); }
+
+    qsizetype memoryUsage() const;
+
+    // تستخدم أثناء البناء فقط، قبل مشاركة الجدول
+    int addDir(int parent, QStringView relPath, const QSharedPointer<const SPIgnoreRules>& dirRules = {});
+    int addFile(int dir, QStringView name);
+    void finish();
+
+private:
+    struct Dir {
+        qint32 parent{};
+        qint32 offset{};
+        qint32 length{};
+    };
+    struct File {
+        qint32 dir{};
+        qint32 offset{};
+        qint32 length{};
+    };
+
+    qint32 intern(QStringView text);
+
+    QString root{};
+    QString pool{};
+    QList<Dir> dirs{};
+    QList<File> files{};
+    QList<QSharedPointer<const SPIgnoreRules>> rules{};
+    QHash<QString, qint32> internIndex{};
+};
+
+using SPPathTablePtr = QSharedPointer<const SPPathTable>;
+
+
+// التغييرات بين لقطتين متتاليتين من الفهرس، والمسارات نسبةً إلى جذر المشروع
+struct SPIndexDelta {
+    QStringList addedFiles{};
+    QStringList removedFiles{};
+    QStringList modifiedFiles{};
+
+    bool isEmpty() const { return addedFiles.isEmpty() and removedFiles.isEmpty() and modifiedFiles.isEmpty(); }
+};
+
+
+// يبني فهرس ملفات المشروع في الخلفية مع احترام .gitignore و .spectrumignore
+// ثم يبقيه محدثاً من أحداث نظام الملفات بإعادة فحص المجلدات المتغيرة فقط
+// يستخدم من خيط الواجهة فقط، أما اللقطات التي يرجعها فيمكن تمريرها لأي خيط
+class SPProjectIndex : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SPProjectIndex(QObject* parent = nullptr);
+    ~SPProjectIndex();
+
+    void setRootPath(const QString& path);
+    QString rootPath() const { return root; }
+
+    SPPathTablePtr snapshot() const { return table; }
+    bool isReady() const { return !table.isNull() and !crawlWatcher->isRunning(); }
+
+    struct Update {
+        SPPathTablePtr table{};
+        SPIndexDelta delta{};
+    };
+
+public slots:
+    void rescan();
+    // dirtyDirs: مجلدات تغير محتواها ويعاد فحصها بدون أبنائها المعروفة
+    void applyChanges(const QStringList& dirtyDirs, const QStringList& modifiedFiles);
+
+signals:
+    void progress(int filesFound);
+    void ready(int fileCount, qint64 elapsedMs);
+    void changed(const SPIndexDelta& delta);
+    // بعض المجلدات تفحص دورياً لأن حد مراقبات النظام نفد، فتتأخر تغييراتها بضع ثوان
+    void watchLimitReached(int polledDirs);
+
+private slots:
+    void onCrawlFinished();
+
+private:
+    void startCrawl(bool incremental, const QStringList& dirtyDirs);
+
+    QString root{};
+    SPPathTablePtr table{};
+
+    QThreadPool* crawlPool{};
+    QFutureWatcher<Update>* crawlWatcher{};
+    QSharedPointer<std::atomic_bool> crawlCancelled{};
+    QElapsedTimer crawlTimer{};
+    bool incrementalCrawl{};
+
+    SPFileWatcher* fileWatcher{};
+    QSet<QString> pendingDirs{};
+    QSet<QString> pendingModified{};
+    QStringList crawlModified{};
+};
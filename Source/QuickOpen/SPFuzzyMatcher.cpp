@@ -0,0 +1,127 @@
+#include "SPFuzzyMatcher.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+
+
+namespace {
+
+// ترتيب النتائج: النقاط الأعلى أولاً ثم ترتيب الملف في الجدول
+bool isBetter(const SPFuzzyMatch& a, const SPFuzzyMatch& b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.file < b.file;
+}
+
+bool isSeparator(QChar ch) {
+    return ch == '/' or ch == '_' or ch == '-' or ch == '.' or ch == ' ';
+}
+
+} // namespace
+
+
+SPFuzzyMatcher::SPFuzzyMatcher(const QString& pattern) {
+    for (QChar ch : pattern) {
+        if (!ch.isSpace()) {
+            this->pattern.append(ch.toCaseFolded());
+        }
+    }
+}
+
+std::optional<int> SPFuzzyMatcher::score(QStringView dir, QStringView name) const {
+    const qsizetype dirLength = dir.isEmpty() ? 0 : dir.size() + 1;
+    const qsizetype length = dirLength + name.size();
+    auto charAt = [&](qsizetype i) -> QChar {
+        if (i >= dirLength) return name[i - dirLength];
+        if (i == dir.size()) return QChar('/');
+        return dir[i];
+    };
+
+    // المرور من نهاية المسار يجعل المطابقات تتجمع في اسم الملف والمجلدات الأقرب إليه
+    qsizetype next = pattern.size() - 1;
+    qsizetype previousMatch = -1;
+    int total = 0;
+    for (qsizetype i = length - 1; i >= 0 and next >= 0; --i) {
+        QChar ch = charAt(i);
+        if (ch.toCaseFolded() != pattern.at(next)) continue;
+
+        int charScore = 16;
+        QChar before = i > 0 ? charAt(i - 1) : QChar('/');
+        if (isSeparator(before)) {
+            charScore += 24; // بداية مقطع من المسار
+        }
+        else if (before.isLower() and ch.isUpper()) {
+            charScore += 16; // camelCase
+        }
+
+        if (previousMatch == i + 1) {
+            charScore += 16; // أحرف متتابعة
+        }
+        else if (previousMatch != -1) {
+            charScore -= int(qMin<qsizetype>(previousMatch - i - 1, 8));
+        }
+
+        if (i >= dirLength) {
+            charScore += 8; // داخل اسم الملف
+        }
+
+        total += charScore;
+        previousMatch = i;
+        --next;
+    }
+
+    if (next >= 0) {
+        return std::nullopt;
+    }
+    // المسارات الأقصر أفضل عند تساوي بقية العوامل
+    return total - int(length / 4);
+}
+
+QList<SPFuzzyMatch> SPFuzzyMatcher::topMatches(const SPPathTable& table, int begin, int end, int limit) const {
+    // كومة صغيرة بحجم الحد الأقصى، وأعلاها هو أسوأ نتيجة محفوظة
+    QList<SPFuzzyMatch> heap{};
+    heap.reserve(limit + 1);
+
+    for (int file = begin; file < end; ++file) {
+        std::optional<int> fileScore = score(table.dirPath(table.fileDir(file)), table.fileName(file));
+        if (!fileScore) continue;
+
+        SPFuzzyMatch match{ file, *fileScore };
+        if (heap.size() < limit) {
+            heap.append(match);
+            std::push_heap(heap.begin(), heap.end(), isBetter);
+        }
+        else if (isBetter(match, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), isBetter);
+            heap.back() = match;
+            std::push_heap(heap.begin(), heap.end(), isBetter);
+        }
+    }
+
+    std::sort(heap.begin(), heap.end(), isBetter);
+    return heap;
+}
+
+QFuture<QList<SPFuzzyMatch>> SPFuzzyMatcher::findAsync(const SPPathTablePtr& table, const QString& pattern, int limit) {
+    // أجزاء صغيرة بما يكفي لتوزيع الحمل بين الأنوية وكبيرة بما يكفي لتقليل كلفة الجدولة
+    constexpr int chunkSize = 8192;
+    QList<QPair<int, int>> chunks{};
+    for (int begin = 0; begin < table->fileCount(); begin += chunkSize) {
+        chunks.append({ begin, qMin(begin + chunkSize, table->fileCount()) });
+    }
+
+    SPFuzzyMatcher matcher(pattern);
+    auto map = [table, matcher, limit](const QPair<int, int>& chunk) {
+        return matcher.topMatches(*table, chunk.first, chunk.second, limit);
+    };
+    auto reduce = [limit](QList<SPFuzzyMatch>& result, const QList<SPFuzzyMatch>& part) {
+        result.append(part);
+        std::sort(result.begin(), result.end(), isBetter);
+        if (result.size() > limit) {
+            result.resize(limit);
+        }
+    };
+
+    return QtConcurrent::mappedReduced<QList<SPFuzzyMatch>>(std::move(chunks), map, reduce,
+                                                            QtConcurrent::UnorderedReduce);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "SPProjectIndex.h"
+
+#include <QString>
+#include <QStringView>
+#include <QList>
+#include <QFuture>
+
+#include <optional>
+
+
+struct SPFuzzyMatch {
+    int file{ -1 };
+    int score{};
+};
+
+
+// مطابقة تقريبية لأحرف البحث مع مسارات المشروع
+// الأحرف يجب أن تظهر بنفس الترتيب، والنقاط تزيد عند بداية المقاطع
+// وعند التتابع وعند المطابقة داخل اسم الملف نفسه
+class SPFuzzyMatcher {
+public:
+    explicit SPFuzzyMatcher(const QString& pattern);
+
+    bool isEmpty() const { return pattern.isEmpty(); }
+
+    // لا يرجع قيمة إذا لم تظهر جميع الأحرف في المسار
+    // النقاط نفسها قد تكون سالبة في المسارات الطويلة ذات المطابقات المتباعدة
+    std::optional<int> score(QStringView dir, QStringView name) const;
+
+    // أفضل النتائج لنطاق من ملفات الجدول
+    QList<SPFuzzyMatch> topMatches(const SPPathTable& table, int begin, int end, int limit) const;
+
+    // توزيع المطابقة على جميع الأنوية ودمج أفضل النتائج من كل جزء
+    static QFuture<QList<SPFuzzyMatch>> findAsync(const SPPathTablePtr& table, const QString& pattern, int limit);
+
+private:
+    QString pattern{};
+};
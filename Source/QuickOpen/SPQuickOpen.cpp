@@ -0,0 +1,119 @@
+#include "SPQuickOpen.h"
+#include "SPTheme.h"
+
+#include <QVBoxLayout>
+#include <QKeyEvent>
+#include <QCoreApplication>
+
+
+SPQuickOpen::SPQuickOpen(QWidget* parent)
+    : QWidget(parent, Qt::Popup | Qt::FramelessWindowHint) {
+    SPTheme::usePopupPalette(this);
+    setAutoFillBackground(true);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(6, 6, 6, 6);
+    layout->setSpacing(4);
+
+    input = new QLineEdit(this);
+    input->setPlaceholderText("ابحث عن ملف في المشروع");
+    listWidget = new QListWidget(this);
+    listWidget->setUniformItemSizes(true);
+    listWidget->setFrameShape(QFrame::NoFrame);
+    listWidget->setSpacing(2);
+
+    layout->addWidget(input);
+    layout->addWidget(listWidget);
+
+    matchWatcher = new QFutureWatcher<QList<SPFuzzyMatch>>(this);
+
+    connect(input, &QLineEdit::textChanged, this, &SPQuickOpen::updateResults);
+    connect(input, &QLineEdit::returnPressed, this, &SPQuickOpen::acceptCurrent);
+    connect(listWidget, &QListWidget::itemActivated, this, &SPQuickOpen::acceptCurrent);
+    connect(matchWatcher, &QFutureWatcher<QList<SPFuzzyMatch>>::finished, this, &SPQuickOpen::onResultsReady);
+
+    // الأسهم تنتقل بين النتائج بينما يبقى التركيز في حقل البحث
+    input->installEventFilter(this);
+}
+
+void SPQuickOpen::popup(const SPPathTablePtr& table) {
+    this->table = table;
+
+    QWidget* window = parentWidget()->window();
+    resize(qMin(700, window->width() - 40), 420);
+    move(window->mapToGlobal(QPoint((window->width() - width()) / 2, 60)));
+
+    input->clear();
+    updateResults();
+    show();
+    input->setFocus();
+}
+
+void SPQuickOpen::refresh(const SPPathTablePtr& table) {
+    if (!isVisible()) return;
+
+    this->table = table;
+    updateResults();
+}
+
+void SPQuickOpen::updateResults() {
+    if (!table) return;
+
+    // إلغاء البحث السابق، فالنتيجة القديمة لم تعد مطلوبة
+    matchWatcher->cancel();
+
+    if (input->text().trimmed().isEmpty()) {
+        QList<SPFuzzyMatch> first{};
+        for (int file = 0; file < qMin(maxResults, table->fileCount()); ++file) {
+            first.append({ file, 0 });
+        }
+        showMatches(first);
+        return;
+    }
+
+    matchWatcher->setFuture(SPFuzzyMatcher::findAsync(table, input->text(), maxResults));
+}
+
+void SPQuickOpen::onResultsReady() {
+    if (matchWatcher->isCanceled()) return;
+    showMatches(matchWatcher->result());
+}
+
+void SPQuickOpen::showMatches(const QList<SPFuzzyMatch>& matches) {
+    listWidget->clear();
+    for (const SPFuzzyMatch& match : matches) {
+        QString dir = table->dirPath(table->fileDir(match.file)).toString();
+        QListWidgetItem* item = new QListWidgetItem(dir.isEmpty()
+            ? table->fileName(match.file).toString()
+            : QString("%1   —   %2").arg(table->fileName(match.file), dir));
+        item->setData(Qt::UserRole, table->absolutePath(match.file));
+        listWidget->addItem(item);
+    }
+    listWidget->setCurrentRow(0);
+}
+
+void SPQuickOpen::acceptCurrent() {
+    QListWidgetItem* item = listWidget->currentItem();
+    if (!item) return;
+
+    hide();
+    emit fileChosen(item->data(Qt::UserRole).toString());
+}
+
+bool SPQuickOpen::eventFilter(QObject* obj, QEvent* event) {
+    if (obj == input and event->type() == QEvent::KeyPress) {
+        QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
+        if (keyEvent->key() == Qt::Key_Up
+            or keyEvent->key() == Qt::Key_Down
+            or keyEvent->key() == Qt::Key_PageUp
+            or keyEvent->key() == Qt::Key_PageDown) {
+            QCoreApplication::sendEvent(listWidget, event);
+            return true;
+        }
+        else if (keyEvent->key() == Qt::Key_Escape) {
+            hide();
+            return true;
+        }
+    }
+    return QWidget::eventFilter(obj, event);
+}
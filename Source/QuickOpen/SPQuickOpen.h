@@ -0,0 +1,42 @@
+#pragma once
+
+#include "SPFuzzyMatcher.h"
+
+#include <QWidget>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QFutureWatcher>
+
+
+// نافذة الفتح السريع (Ctrl+P) للبحث عن ملفات المشروع بالمطابقة التقريبية
+class SPQuickOpen : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit SPQuickOpen(QWidget* parent = nullptr);
+
+    void popup(const SPPathTablePtr& table);
+    // يستبدل الجدول بلقطة أحدث من الفهرس مع إبقاء النص المكتوب
+    void refresh(const SPPathTablePtr& table);
+
+signals:
+    void fileChosen(const QString& filePath);
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+
+private slots:
+    void updateResults();
+    void onResultsReady();
+    void acceptCurrent();
+
+private:
+    void showMatches(const QList<SPFuzzyMatch>& matches);
+
+    QLineEdit* input{};
+    QListWidget* listWidget{};
+    SPPathTablePtr table{};
+    QFutureWatcher<QList<SPFuzzyMatch>>* matchWatcher{};
+
+    static constexpr int maxResults = 50;
+};
@@ -0,0 +1,345 @@
+#include "SPFindInFiles.h"
+#include "SPFileCache.h"
+#include "SPTrace.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QStringMatcher>
+
+#include <atomic>
+#include <cstring>
+
+
+struct SPSearchJob {
+    SPSearchQuery query{};
+    SPPathTablePtr table{};
+    QHash<QString, QString> openDocuments{};
+    QStringList documentPaths{};
+
+    // البحث بالبايتات ممكن فقط للنص الحرفي الذي لا يتأثر بحالة الأحرف
+    bool byteSearch{};
+    QByteArray needle{};
+    QStringMatcher matcher{};
+    QRegularExpression regex{};
+
+    int generation{};
+    QElapsedTimer timer{};
+    std::atomic_int nextItem{};
+    std::atomic_int filesSearched{};
+    std::atomic_int matchCount{};
+    std::atomic_int workersLeft{};
+    std::atomic_bool cancelled{};
+};
+
+
+namespace {
+
+constexpr qint64 maxFileSize = 64 * 1024 * 1024;
+constexpr int maxLineText = 300;
+
+bool isWordChar(char32_t ch) {
+    return ch == '_' or QChar::isLetterOrNumber(ch) or QChar::isMark(ch);
+}
+
+// فك ترميز محرف UTF-8 يبدأ عند pos
+char32_t decodeAt(const char* pos, const char* end) {
+    const unsigned char lead = static_cast<unsigned char>(*pos);
+    int extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+    if (pos + extra >= end) return lead;
+
+    char32_t ch = extra == 0 ? lead : lead & (0x3F >> extra);
+    for (int i = 1; i <= extra; ++i) {
+        ch = (ch << 6) | (static_cast<unsigned char>(pos[i]) & 0x3F);
+    }
+    return ch;
+}
+
+// فك ترميز المحرف الذي ينتهي قبل pos مباشرة
+char32_t decodeBefore(const char* begin, const char* pos) {
+    const char* start = pos - 1;
+    while (start > begin and (static_cast<unsigned char>(*start) & 0xC0) == 0x80) {
+        --start;
+    }
+    return decodeAt(start, pos);
+}
+
+bool isBinary(const char* data, qint64 size) {
+    return std::memchr(data, '\0', size_t(qMin<qint64>(size, 8192))) != nullptr;
+}
+
+QString clippedLine(QString line) {
+    if (line.endsWith('\r')) line.chop(1);
+    if (line.size() > maxLineText) line.truncate(maxLineText);
+    return line;
+}
+
+// يضيف المطابقة مع حساب رقم السطر تدريجياً من آخر موضع تمت معالجته
+class LineTracker {
+public:
+    explicit LineTracker(const QString& text) : text(text) {}
+
+    void add(qsizetype start, qsizetype length, QList<SPSearchMatch>& matches) {
+        while (true) {
+            qsizetype newline = text.indexOf('\n', scanned);
+            if (newline == -1 or newline >= start) break;
+            ++line;
+            lineStart = newline + 1;
+            scanned = newline + 1;
+        }
+        scanned = qMax(scanned, lineStart);
+
+        qsizetype lineEnd = text.indexOf('\n', start);
+        if (lineEnd == -1) lineEnd = text.size();
+        matches.append({ line, int(start - lineStart), int(length),
+                         clippedLine(text.mid(lineStart, lineEnd - lineStart)) });
+    }
+
+private:
+    const QString& text;
+    qsizetype scanned{};
+    qsizetype lineStart{};
+    int line{};
+};
+
+bool isWholeWord(const QString& text, qsizetype start, qsizetype length) {
+    if (start > 0 and isWordChar(text.at(start - 1).unicode())) return false;
+    qsizetype end = start + length;
+    if (end < text.size() and isWordChar(text.at(end).unicode())) return false;
+    return true;
+}
+
+void searchText(const QString& text, SPSearchJob& job, QList<SPFileMatches>& batch, const QString& path) {
+    QList<SPSearchMatch> matches{};
+    LineTracker tracker(text);
+
+    auto accept = [&](qsizetype start, qsizetype length) {
+        if (job.query.wholeWord and !isWholeWord(text, start, length)) return true;
+        tracker.add(start, length, matches);
+        return matches.size() < SPFindInFiles::maxMatchesPerFile;
+    };
+
+    if (job.query.regex) {
+        QRegularExpressionMatchIterator it = job.regex.globalMatch(text);
+        while (it.hasNext() and !job.cancelled.load(std::memory_order_relaxed)) {
+            QRegularExpressionMatch match = it.next();
+            if (match.capturedLength() == 0) continue;
+            if (!accept(match.capturedStart(), match.capturedLength())) break;
+        }
+    }
+    else {
+        qsizetype from = 0;
+        while (!job.cancelled.load(std::memory_order_relaxed)) {
+            qsizetype start = job.matcher.indexIn(text, from);
+            if (start == -1) break;
+            if (!accept(start, job.query.text.size())) break;
+            from = start + job.query.text.size();
+        }
+    }
+
+    if (!matches.isEmpty()) {
+        job.matchCount += int(matches.size());
+        batch.append({ path, matches });
+    }
+}
+
+// البحث الحرفي في بايتات الملف: memchr يقفز إلى مواضع البايت الأول (وهو مسرّع بـ SIMD في glibc)
+// ثم memcmp للتحقق، ولا يتم فك الترميز إلا للأسطر التي تحتوي مطابقة
+void searchBytes(const char* data, qint64 size, SPSearchJob& job, QList<SPFileMatches>& batch, const QString& path) {
+    const char* begin = data;
+    const char* end = data + size;
+    const char* needle = job.needle.constData();
+    const qsizetype needleSize = job.needle.size();
+    const char first = needle[0];
+
+    QList<SPSearchMatch> matches{};
+    const char* scanned = begin;
+    const char* lineStart = begin;
+    int line = 0;
+
+    const char* pos = begin;
+    while (end - pos >= needleSize and !job.cancelled.load(std::memory_order_relaxed)) {
+        const char* hit = static_cast<const char*>(std::memchr(pos, first, size_t(end - pos - needleSize + 1)));
+        if (!hit) break;
+        if (std::memcmp(hit + 1, needle + 1, size_t(needleSize - 1)) != 0) {
+            pos = hit + 1;
+            continue;
+        }
+        pos = hit + needleSize;
+
+        if (job.query.wholeWord) {
+            if (hit > begin and isWordChar(decodeBefore(begin, hit))) continue;
+            if (pos < end and isWordChar(decodeAt(pos, end))) continue;
+        }
+
+        // عد الأسطر بين آخر موضع والمطابقة الحالية
+        while (const char* newline = static_cast<const char*>(std::memchr(scanned, '\n', size_t(hit - scanned)))) {
+            ++line;
+            lineStart = newline + 1;
+            scanned = newline + 1;
+        }
+        scanned = hit;
+
+        const char* lineEnd = static_cast<const char*>(std::memchr(hit, '\n', size_t(end - hit)));
+        if (!lineEnd) lineEnd = end;
+
+        int column = int(QString::fromUtf8(lineStart, hit - lineStart).size());
+        int length = int(job.query.text.size());
+        matches.append({ line, column, length,
+                         clippedLine(QString::fromUtf8(lineStart, qMin<qsizetype>(lineEnd - lineStart, maxLineText * 4))) });
+        if (matches.size() >= SPFindInFiles::maxMatchesPerFile) break;
+    }
+
+    if (!matches.isEmpty()) {
+        job.matchCount += int(matches.size());
+        batch.append({ path, matches });
+    }
+}
+
+void searchFile(const QString& path, SPSearchJob& job, QList<SPFileMatches>& batch) {
+    // المحتوى نسخة يملكها مخزن في الذاكرة المؤقتة المشتركة، تبقى ثابتة حتى لو أعيدت كتابة الملف أثناء البحث
+    // فتكرار البحث في نفس الملفات لا يعيد قراءتها من القرص
+    SPFileBufferPtr buffer = SPFileCache::instance().read(path, maxFileSize);
+    if (!buffer or buffer->size() == 0) return;
+
+    const char* data = buffer->data();
+    qint64 size = buffer->size();
+    if (isBinary(data, size)) return;
+
+    if (job.byteSearch) {
+        searchBytes(data, size, job, batch, path);
+    }
+    else {
+        searchText(QString::fromUtf8(data, size), job, batch, path);
+    }
+}
+
+} // namespace
+
+
+SPFindInFiles::SPFindInFiles(QObject* parent) : QObject(parent) {
+    searchPool = new QThreadPool(this);
+    searchPool->setMaxThreadCount(QThread::idealThreadCount());
+}
+
+SPFindInFiles::~SPFindInFiles() {
+    cancel();
+    searchPool->waitForDone();
+}
+
+void SPFindInFiles::start(const SPSearchQuery& query, const SPPathTablePtr& table,
+                          const QHash<QString, QString>& openDocuments) {
+    cancel();
+    if (query.text.isEmpty() or !table) return;
+
+    QSharedPointer<SPSearchJob> newJob = QSharedPointer<SPSearchJob>::create();
+    newJob->query = query;
+    newJob->table = table;
+    newJob->openDocuments = openDocuments;
+    newJob->documentPaths = openDocuments.keys();
+    newJob->generation = ++generation;
+
+    // النص الذي لا يحتوي أحرفاً لها حالة (مثل العربية) يبحث عنه بالبايتات حتى عند تجاهل الحالة
+    bool hasCase = false;
+    for (QChar ch : query.text) {
+        if (ch.isUpper() or ch.isLower() or ch.isTitleCase()) {
+            hasCase = true;
+            break;
+        }
+    }
+    Qt::CaseSensitivity sensitivity = query.caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    newJob->byteSearch = !query.regex and (query.caseSensitive or !hasCase);
+    newJob->needle = query.text.toUtf8();
+    newJob->matcher = QStringMatcher(query.text, sensitivity);
+    if (query.regex) {
+        QRegularExpression::PatternOptions options = QRegularExpression::UseUnicodePropertiesOption
+                                                   | QRegularExpression::MultilineOption;
+        if (!query.caseSensitive) options |= QRegularExpression::CaseInsensitiveOption;
+        newJob->regex = QRegularExpression(query.text, options);
+        if (!newJob->regex.isValid()) {
+            emit finished(0, 0, 0, false);
+            return;
+        }
+        newJob->regex.optimize();
+    }
+
+    job = newJob;
+    running = true;
+    newJob->timer.start();
+
+    int workers = searchPool->maxThreadCount();
+    newJob->workersLeft = workers;
+    for (int i = 0; i < workers; ++i) {
+        searchPool->start([this, newJob]() { runWorker(this, newJob); });
+    }
+}
+
+void SPFindInFiles::cancel() {
+    if (job) {
+        job->cancelled = true;
+    }
+}
+
+void SPFindInFiles::runWorker(SPFindInFiles* engine, QSharedPointer<SPSearchJob> job) {
+    const int documents = int(job->documentPaths.size());
+    const int total = documents + job->table->fileCount();
+
+    SP_TRACE_SCOPE("findInFiles.worker");
+    QList<SPFileMatches> batch{};
+    QElapsedTimer flushTimer{};
+    flushTimer.start();
+
+    auto flush = [&]() {
+        if (batch.isEmpty()) return;
+        SP_TRACE_SCOPE("findInFiles.flush");
+        int generation = job->generation;
+        QMetaObject::invokeMethod(engine, [engine, generation, results = std::move(batch)]() {
+            if (engine->generation == generation) {
+                emit engine->resultsReady(results);
+            }
+        }, Qt::QueuedConnection);
+        batch = {};
+        flushTimer.restart();
+    };
+
+    // المستندات المفتوحة أولاً ثم ملفات المشروع، والعنصر التالي يوزع عبر عداد ذري
+    for (;;) {
+        if (job->cancelled.load(std::memory_order_relaxed)) break;
+        if (job->matchCount.load(std::memory_order_relaxed) >= maxTotalMatches) break;
+
+        int item = job->nextItem.fetch_add(1, std::memory_order_relaxed);
+        if (item >= total) break;
+
+        if (item < documents) {
+            const QString& path = job->documentPaths.at(item);
+            searchText(job->openDocuments.value(path), *job, batch, path);
+        }
+        else {
+            QString path = job->table->absolutePath(item - documents);
+            if (job->openDocuments.contains(path)) continue;
+            searchFile(path, *job, batch);
+        }
+        ++job->filesSearched;
+
+        // إرسال النتائج على دفعات لكي تظهر أثناء البحث دون إغراق حلقة الأحداث
+        if (batch.size() >= 32 or (!batch.isEmpty() and flushTimer.elapsed() > 50)) {
+            flush();
+        }
+    }
+    flush();
+
+    if (job->workersLeft.fetch_sub(1) == 1) {
+        int generation = job->generation;
+        QMetaObject::invokeMethod(engine, [engine, generation]() {
+            engine->onWorkerFinished(generation);
+        }, Qt::QueuedConnection);
+    }
+}
+
+void SPFindInFiles::onWorkerFinished(int generation) {
+    if (generation != this->generation or !job) return;
+
+    running = false;
+    emit finished(job->filesSearched, job->matchCount, job->timer.elapsed(), job->cancelled);
+}
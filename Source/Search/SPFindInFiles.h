@@ -0,0 +1,68 @@
+#pragma once
+
+#include "SPProjectIndex.h"
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QSharedPointer>
+
+class QThreadPool;
+struct SPSearchJob;
+
+
+struct SPSearchQuery {
+    QString text{};
+    bool regex{};
+    bool wholeWord{};
+    bool caseSensitive{};
+};
+
+struct SPSearchMatch {
+    int line{};     // يبدأ من 0
+    int column{};   // بعدد QChar داخل السطر
+    int length{};
+    QString lineText{};
+};
+
+struct SPFileMatches {
+    QString filePath{};
+    QList<SPSearchMatch> matches{};
+};
+
+
+// بحث متوازي في ملفات المشروع
+// الملفات تقرأ من الذاكرة المؤقتة المشتركة وتوزع على مجموعة خيوط، والنص الحرفي يبحث عنه
+// بالبايتات مباشرة (memchr للبايت الأول ثم التحقق) بدون تحويل الملف إلى QString
+// المستندات المفتوحة يتم البحث في نصها الموجود في الذاكرة بدلاً من الملف المحفوظ
+class SPFindInFiles : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SPFindInFiles(QObject* parent = nullptr);
+    ~SPFindInFiles();
+
+    // openDocuments: مسار المستند المفتوح ← نصه الحالي
+    void start(const SPSearchQuery& query, const SPPathTablePtr& table,
+               const QHash<QString, QString>& openDocuments);
+    void cancel();
+    bool isRunning() const { return running; }
+
+    static constexpr int maxMatchesPerFile = 1000;
+    static constexpr int maxTotalMatches = 100000;
+
+signals:
+    // تصل النتائج على دفعات أثناء البحث
+    void resultsReady(const QList<SPFileMatches>& results);
+    void finished(int filesSearched, int matchCount, qint64 elapsedMs, bool cancelled);
+
+private:
+    static void runWorker(SPFindInFiles* engine, QSharedPointer<SPSearchJob> job);
+    void onWorkerFinished(int generation);
+
+    QThreadPool* searchPool{};
+    QSharedPointer<SPSearchJob> job{};
+    int generation{};
+    bool running{};
+};
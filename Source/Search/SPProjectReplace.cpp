@@ -0,0 +1,335 @@
+#include "SPProjectReplace.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <io.h>
+#endif
+
+
+/* ---------------------------------- Plan ---------------------------------- */
+
+bool SPReplacePlan::prepare(const SPSearchQuery& searchQuery, const QString& replacementText) {
+    query = searchQuery;
+    replacement = replacementText;
+    if (!query.regex) return true;
+
+    QRegularExpression::PatternOptions options = QRegularExpression::UseUnicodePropertiesOption
+                                               | QRegularExpression::MultilineOption;
+    if (!query.caseSensitive) options |= QRegularExpression::CaseInsensitiveOption;
+    regex = QRegularExpression(query.text, options);
+    return regex.isValid();
+}
+
+bool SPReplacePlan::computeEdits(const QString& text, const QList<SPSearchMatch>& matches,
+                                 QList<SPReplaceEdit>& edits) const {
+    QList<qsizetype> lineStarts{ 0 };
+    for (qsizetype pos = text.indexOf('\n'); pos != -1; pos = text.indexOf('\n', pos + 1)) {
+        lineStarts.append(pos + 1);
+    }
+
+    Qt::CaseSensitivity sensitivity = query.caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    qsizetype lastEnd = 0;
+    for (const SPSearchMatch& match : matches) {
+        if (match.line < 0 or match.line >= lineStarts.size()) return false;
+
+        qsizetype offset = lineStarts.at(match.line) + match.column;
+        if (offset < lastEnd or offset + match.length > text.size()) return false;
+
+        if (query.regex) {
+            QRegularExpressionMatch found = regex.match(text, offset, QRegularExpression::NormalMatch,
+                                                        QRegularExpression::AnchorAtOffsetMatchOption);
+            if (!found.hasMatch() or found.capturedLength() != match.length) return false;
+            edits.append({ offset, match.length, expand(found) });
+        }
+        else {
+            if (QStringView(text).mid(offset, match.length).compare(query.text, sensitivity) != 0) return false;
+            edits.append({ offset, match.length, replacement });
+        }
+        lastEnd = offset + match.length;
+    }
+    return true;
+}
+
+QString SPReplacePlan::previewLine(const QString& lineText, const SPSearchMatch& match) const {
+    QString after = replacement;
+    if (query.regex) {
+        QRegularExpressionMatch found = regex.match(lineText, match.column, QRegularExpression::NormalMatch,
+                                                    QRegularExpression::AnchorAtOffsetMatchOption);
+        if (found.hasMatch()) after = expand(found);
+    }
+    return lineText.left(match.column) + after + lineText.mid(match.column + match.length);
+}
+
+QString SPReplacePlan::applyEdits(const QString& text, const QList<SPReplaceEdit>& edits) {
+    qsizetype size = text.size();
+    for (const SPReplaceEdit& edit : edits) {
+        size += edit.replacement.size() - edit.length;
+    }
+
+    QString result{};
+    result.reserve(size);
+    qsizetype from = 0;
+    for (const SPReplaceEdit& edit : edits) {
+        result.append(QStringView(text).mid(from, edit.offset - from));
+        result.append(edit.replacement);
+        from = edit.offset + edit.length;
+    }
+    result.append(QStringView(text).mid(from));
+    return result;
+}
+
+// يدعم $0 إلى $9 و \0 إلى \9 للمجموعات، و $$ لعلامة الدولار نفسها
+QString SPReplacePlan::expand(const QRegularExpressionMatch& match) const {
+    QString result{};
+    result.reserve(replacement.size());
+    for (qsizetype i = 0; i < replacement.size(); ++i) {
+        QChar ch = replacement.at(i);
+        if ((ch == '$' or ch == '\\') and i + 1 < replacement.size()) {
+            QChar next = replacement.at(i + 1);
+            if (next.isDigit()) {
+                result.append(match.captured(next.digitValue()));
+                ++i;
+                continue;
+            }
+            if (next == ch) {
+                result.append(ch);
+                ++i;
+                continue;
+            }
+        }
+        result.append(ch);
+    }
+    return result;
+}
+
+
+/* ---------------------------------- Replace ---------------------------------- */
+
+namespace {
+
+struct PreparedFile {
+    const SPFileMatches* source{};
+    // الملف الفعلي بعد حل الروابط الرمزية، والنقل يتم بجانبه
+    QString targetPath{};
+    QString tempPath{};
+    QString backupPath{};
+    int replacements{};
+    QString error{};
+};
+
+// النقل لا يضمن وصول محتوى الملف إلى القرص قبله، فانقطاع الكهرباء قد يترك ملفاً فارغاً مكان الأصلي
+bool syncFile(QFile& file) {
+#if defined(Q_OS_UNIX)
+    return ::fsync(file.handle()) == 0;
+#elif defined(Q_OS_WIN)
+    return ::_commit(file.handle()) == 0;
+#else
+    Q_UNUSED(file);
+    return true;
+#endif
+}
+
+// أسماء الملفات المنقولة تثبت بتثبيت المجلد نفسه
+void syncDirectory(const QString& path) {
+#if defined(Q_OS_UNIX)
+    int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+#else
+    Q_UNUSED(path);
+#endif
+}
+
+// يكتب المحتوى الجديد في ملف مؤقت بجانب الأصلي ليكون النقل لاحقاً داخل نفس نظام الملفات
+void prepareFile(PreparedFile& prepared, const SPReplacePlan& plan, const std::atomic_bool& failed) {
+    if (failed.load(std::memory_order_relaxed)) return;
+
+    const QString& path = prepared.targetPath;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        prepared.error = QString("تعذرت قراءة %1").arg(path);
+        return;
+    }
+    QByteArray bytes = file.readAll();
+    file.close();
+
+    // الملف الذي لا يعود بنفس البايتات بعد فك الترميز لا يعدل، لكي لا يفسد محتواه
+    QString text = QString::fromUtf8(bytes);
+    if (text.toUtf8() != bytes) {
+        prepared.error = QString("ترميز الملف ليس UTF-8 صالحاً: %1").arg(path);
+        return;
+    }
+
+    QList<SPReplaceEdit> edits{};
+    if (!plan.computeEdits(text, prepared.source->matches, edits)) {
+        prepared.error = QString("تغير الملف منذ البحث: %1").arg(path);
+        return;
+    }
+
+    prepared.tempPath = path + ".sp-replace-tmp";
+    QFile temp(prepared.tempPath);
+    if (!temp.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        prepared.error = QString("تعذرت الكتابة بجانب %1").arg(path);
+        prepared.tempPath.clear();
+        return;
+    }
+    QByteArray output = SPReplacePlan::applyEdits(text, edits).toUtf8();
+    bool written = temp.write(output) == output.size() and temp.flush() and syncFile(temp);
+    temp.close();
+    temp.setPermissions(QFile::permissions(path));
+    if (!written) {
+        prepared.error = QString("تعذرت الكتابة بجانب %1").arg(path);
+        return;
+    }
+
+    prepared.replacements = int(edits.size());
+}
+
+SPReplaceResult runReplace(QThreadPool* pool, const QList<SPFileMatches>& files, const SPReplacePlan& plan) {
+    QElapsedTimer timer{};
+    timer.start();
+
+    // الرابط وما يشير إليه، أو رابطان لنفس الملف، يعدلان مرة واحدة فقط
+    SPReplaceResult result{};
+    QList<PreparedFile> prepared{};
+    QSet<QString> targets{};
+    for (const SPFileMatches& file : files) {
+        QString target = QFileInfo(file.filePath).canonicalFilePath();
+        if (target.isEmpty()) {
+            result.error = QString("تعذرت قراءة %1").arg(file.filePath);
+            result.elapsedMs = timer.elapsed();
+            return result;
+        }
+        if (targets.contains(target)) continue;
+        targets.insert(target);
+        prepared.append({ &file, target });
+    }
+
+    std::atomic_bool failed{};
+    QtConcurrent::blockingMap(pool, prepared, [&plan, &failed](PreparedFile& file) {
+        prepareFile(file, plan, failed);
+        if (!file.error.isEmpty()) failed = true;
+    });
+
+    auto removeTemps = [&prepared]() {
+        for (const PreparedFile& file : std::as_const(prepared)) {
+            if (!file.tempPath.isEmpty()) QFile::remove(file.tempPath);
+        }
+    };
+
+    if (failed) {
+        removeTemps();
+        auto it = std::find_if(prepared.cbegin(), prepared.cend(), [](const PreparedFile& file) {
+            return !file.error.isEmpty();
+        });
+        result.error = it->error;
+        result.elapsedMs = timer.elapsed();
+        return result;
+    }
+
+    // النقل سريع لكل ملف، لذلك يتم بالترتيب لكي يمكن التراجع عنه بدقة
+    qsizetype committed = 0;
+    for (; committed < prepared.size(); ++committed) {
+        PreparedFile& file = prepared[committed];
+        const QString& path = file.targetPath;
+        file.backupPath = path + ".sp-replace-bak";
+        QFile::remove(file.backupPath);
+
+        if (!QFile::rename(path, file.backupPath)) {
+            result.error = QString("تعذر نقل %1").arg(path);
+            file.backupPath.clear();
+            break;
+        }
+        if (!QFile::rename(file.tempPath, path)) {
+            if (!QFile::rename(file.backupPath, path)) {
+                result.strandedBackups.append(file.backupPath);
+            }
+            result.error = QString("تعذر استبدال %1").arg(path);
+            file.backupPath.clear();
+            break;
+        }
+        file.tempPath.clear();
+    }
+
+    QSet<QString> directories{};
+    for (qsizetype i = 0; i < committed; ++i) {
+        directories.insert(QFileInfo(prepared.at(i).targetPath).absolutePath());
+    }
+
+    if (!result.error.isEmpty()) {
+        for (qsizetype i = committed - 1; i >= 0; --i) {
+            const QString& path = prepared.at(i).targetPath;
+            QFile::remove(path);
+            if (!QFile::rename(prepared.at(i).backupPath, path)) {
+                result.strandedBackups.append(prepared.at(i).backupPath);
+            }
+        }
+        removeTemps();
+        for (const QString& directory : std::as_const(directories)) {
+            syncDirectory(directory);
+        }
+        if (!result.strandedBackups.isEmpty()) {
+            result.error += QString("، وتعذرت إعادة %1 ملف ومحتواها الأصلي في: %2")
+                                .arg(result.strandedBackups.size())
+                                .arg(result.strandedBackups.join("، "));
+        }
+        result.elapsedMs = timer.elapsed();
+        return result;
+    }
+
+    for (const QString& directory : std::as_const(directories)) {
+        syncDirectory(directory);
+    }
+
+    for (const PreparedFile& file : std::as_const(prepared)) {
+        QFile::remove(file.backupPath);
+        result.replacements += file.replacements;
+    }
+    result.ok = true;
+    result.filesChanged = int(prepared.size());
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+} // namespace
+
+
+SPProjectReplace::SPProjectReplace(QObject* parent) : QObject(parent) {
+    // الكتابة مقيدة بالقرص أكثر من المعالج، فعدد خيوط أكبر قليلاً يبقي القرص مشغولاً
+    writePool = new QThreadPool(this);
+    writePool->setMaxThreadCount(QThread::idealThreadCount() * 2);
+
+    watcher = new QFutureWatcher<SPReplaceResult>(this);
+    connect(watcher, &QFutureWatcher<SPReplaceResult>::finished, this, [this]() {
+        emit finished(watcher->result());
+    });
+}
+
+SPProjectReplace::~SPProjectReplace() {
+    // لا يجوز قطع العملية في منتصفها، وإلا بقيت ملفات بدون تراجع
+    watcher->waitForFinished();
+}
+
+void SPProjectReplace::start(const QList<SPFileMatches>& files, const SPReplacePlan& plan) {
+    if (watcher->isRunning()) return;
+
+    QThreadPool* pool = writePool;
+    watcher->setFuture(QtConcurrent::run([pool, files, plan]() {
+        return runReplace(pool, files, plan);
+    }));
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "SPFindInFiles.h"
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QStringList>
+#include <QRegularExpression>
+#include <QFutureWatcher>
+
+class QThreadPool;
+
+
+struct SPReplaceEdit {
+    qsizetype offset{};
+    qsizetype length{};
+    QString replacement{};
+};
+
+// استعلام البحث مع نص الاستبدال، والتعبير النمطي يترجم مرة واحدة لكل العملية
+struct SPReplacePlan {
+    SPSearchQuery query{};
+    QString replacement{};
+    QRegularExpression regex{};
+
+    // يرجع false إذا كان التعبير النمطي غير صالح
+    bool prepare(const SPSearchQuery& searchQuery, const QString& replacementText);
+
+    // يحول المطابقات إلى تعديلات على النص بعد التحقق أن النص في كل موضع ما زال مطابقاً
+    // يرجع false إذا تغير النص منذ البحث، فلا يجوز الاستبدال فيه
+    bool computeEdits(const QString& text, const QList<SPSearchMatch>& matches, QList<SPReplaceEdit>& edits) const;
+    // معاينة السطر بعد الاستبدال، للعرض في لوحة البحث
+    QString previewLine(const QString& lineText, const SPSearchMatch& match) const;
+
+    static QString applyEdits(const QString& text, const QList<SPReplaceEdit>& edits);
+
+private:
+    QString expand(const QRegularExpressionMatch& match) const;
+};
+
+struct SPReplaceResult {
+    bool ok{};
+    int filesChanged{};
+    int replacements{};
+    qint64 elapsedMs{};
+    QString error{};
+    // ملفات تعذرت إعادتها عند التراجع، ومحتواها الأصلي باق في نسخها الاحتياطية
+    QStringList strandedBackups{};
+};
+
+
+// استبدال في ملفات المشروع المغلقة كعملية واحدة: إما أن تتغير كل الملفات أو لا يتغير شيء
+// المرحلة الأولى متوازية: كل ملف يقرأ ويتحقق منه ويكتب محتواه الجديد في ملف مؤقت بجانبه ويثبته على القرص
+// المرحلة الثانية: كل ملف أصلي ينقل إلى نسخة احتياطية ثم ينقل المؤقت مكانه
+// وعند أي فشل تعاد النسخ الاحتياطية للملفات التي تم نقلها وتحذف الملفات المؤقتة
+// الروابط الرمزية تحل أولاً، فيستبدل الملف الذي تشير إليه ويبقى الرابط كما هو
+class SPProjectReplace : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SPProjectReplace(QObject* parent = nullptr);
+    ~SPProjectReplace();
+
+    void start(const QList<SPFileMatches>& files, const SPReplacePlan& plan);
+    bool isRunning() const { return watcher->isRunning(); }
+
+signals:
+    void finished(const SPReplaceResult& result);
+
+private:
+    QThreadPool* writePool{};
+    QFutureWatcher<SPReplaceResult>* watcher{};
+};
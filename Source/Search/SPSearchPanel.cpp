@@ -0,0 +1,237 @@
+#include "SPSearchPanel.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+
+
+SPSearchPanel::SPSearchPanel(QWidget* parent)
+    : QDockWidget(parent) {
+    setWindowTitle("البحث في المشروع");
+    setFont(QFont("Tajawal"));
+    setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetClosable);
+
+    engine = new SPFindInFiles(this);
+
+    QWidget* container = new QWidget(this);
+    // خلفية اللوحة بلون المحرر، وإطار حقول الإدخال يرسمه نمط البرنامج
+    container->setBackgroundRole(QPalette::Base);
+    container->setAutoFillBackground(true);
+    QVBoxLayout* layout = new QVBoxLayout(container);
+    layout->setContentsMargins(6, 6, 6, 6);
+    layout->setSpacing(4);
+
+    QHBoxLayout* queryLayout = new QHBoxLayout();
+    input = new QLineEdit(container);
+    input->setPlaceholderText("النص المراد البحث عنه");
+    searchButton = new QPushButton("بحث", container);
+    queryLayout->addWidget(input);
+    queryLayout->addWidget(searchButton);
+
+    QHBoxLayout* replaceLayout = new QHBoxLayout();
+    replaceInput = new QLineEdit(container);
+    replaceInput->setPlaceholderText("الاستبدال بـ");
+    replaceButton = new QPushButton("استبدال المحدد", container);
+    replaceButton->setEnabled(false);
+    replaceLayout->addWidget(replaceInput);
+    replaceLayout->addWidget(replaceButton);
+
+    QHBoxLayout* optionsLayout = new QHBoxLayout();
+    wholeWordCheck = new QCheckBox("كلمة كاملة", container);
+    regexCheck = new QCheckBox("تعبير نمطي", container);
+    caseCheck = new QCheckBox("مطابقة حالة الأحرف", container);
+    statusLabel = new QLabel(container);
+    optionsLayout->addWidget(wholeWordCheck);
+    optionsLayout->addWidget(regexCheck);
+    optionsLayout->addWidget(caseCheck);
+    optionsLayout->addStretch();
+    optionsLayout->addWidget(statusLabel);
+
+    resultsTree = new QTreeWidget(container);
+    resultsTree->setHeaderHidden(true);
+    resultsTree->setUniformRowHeights(true);
+    resultsTree->setFrameShape(QFrame::NoFrame);
+
+    layout->addLayout(queryLayout);
+    layout->addLayout(replaceLayout);
+    layout->addLayout(optionsLayout);
+    layout->addWidget(resultsTree);
+    setWidget(container);
+
+    connect(input, &QLineEdit::returnPressed, this, &SPSearchPanel::startSearch);
+    connect(searchButton, &QPushButton::clicked, this, [this]() {
+        if (engine->isRunning()) {
+            engine->cancel();
+        } else {
+            startSearch();
+        }
+    });
+    connect(engine, &SPFindInFiles::resultsReady, this, &SPSearchPanel::onResultsReady);
+    connect(engine, &SPFindInFiles::finished, this, &SPSearchPanel::onSearchFinished);
+    connect(resultsTree, &QTreeWidget::itemActivated, this, &SPSearchPanel::onItemActivated);
+    connect(replaceInput, &QLineEdit::textChanged, this, &SPSearchPanel::updatePreview);
+    connect(replaceButton, &QPushButton::clicked, this, &SPSearchPanel::requestReplace);
+}
+
+void SPSearchPanel::setSearchSource(const SPPathTablePtr& table, const QHash<QString, QString>& openDocuments) {
+    this->table = table;
+    this->openDocuments = openDocuments;
+}
+
+void SPSearchPanel::focusInput() {
+    show();
+    raise();
+    input->setFocus();
+    input->selectAll();
+}
+
+void SPSearchPanel::startSearch() {
+    if (input->text().isEmpty()) return;
+
+    emit searchRequested();
+    if (!table) {
+        statusLabel->setText("لا يوجد مشروع مفهرس");
+        return;
+    }
+
+    resultsTree->clear();
+    statusLabel->setText("جاري البحث...");
+    searchButton->setText("إيقاف");
+    replaceButton->setEnabled(false);
+
+    SPSearchQuery query{};
+    query.text = input->text();
+    query.wholeWord = wholeWordCheck->isChecked();
+    query.regex = regexCheck->isChecked();
+    query.caseSensitive = caseCheck->isChecked();
+
+    // الاستبدال يستخدم استعلام النتائج المعروضة وليس حالة الخيارات الحالية
+    lastQuery = query;
+    previewing = !replaceInput->text().isEmpty() and previewPlan.prepare(lastQuery, replaceInput->text());
+    engine->start(query, table, openDocuments);
+}
+
+void SPSearchPanel::onResultsReady(const QList<SPFileMatches>& results) {
+    for (const SPFileMatches& file : results) {
+        QTreeWidgetItem* fileItem = new QTreeWidgetItem(resultsTree);
+        fileItem->setText(0, QString("%1 (%2)").arg(displayPath(file.filePath)).arg(file.matches.size()));
+        fileItem->setData(0, Qt::UserRole, file.filePath);
+        fileItem->setData(0, Qt::UserRole + 1, -1);
+        // إلغاء تحديد الملف أو المطابقة يستثنيها من الاستبدال
+        fileItem->setFlags(fileItem->flags() | Qt::ItemIsUserCheckable | Qt::ItemIsAutoTristate);
+        fileItem->setCheckState(0, Qt::Checked);
+
+        for (const SPSearchMatch& match : file.matches) {
+            QTreeWidgetItem* matchItem = new QTreeWidgetItem(fileItem);
+            matchItem->setData(0, Qt::UserRole, file.filePath);
+            matchItem->setData(0, Qt::UserRole + 1, match.line);
+            matchItem->setData(0, Qt::UserRole + 2, match.column);
+            matchItem->setData(0, Qt::UserRole + 3, match.length);
+            matchItem->setData(0, Qt::UserRole + 4, match.lineText);
+            matchItem->setFlags(matchItem->flags() | Qt::ItemIsUserCheckable);
+            matchItem->setCheckState(0, Qt::Checked);
+            setMatchText(matchItem);
+        }
+        fileItem->setExpanded(true);
+    }
+}
+
+void SPSearchPanel::onSearchFinished(int filesSearched, int matchCount, qint64 elapsedMs, bool cancelled) {
+    searchButton->setText("بحث");
+    replaceButton->setEnabled(matchCount > 0);
+    QString status = QString("%1 نتيجة في %2 ملف (%3 مللي ثانية)")
+                         .arg(matchCount).arg(filesSearched).arg(elapsedMs);
+    if (cancelled) {
+        status += " - تم الإيقاف";
+    }
+    else if (matchCount >= SPFindInFiles::maxTotalMatches) {
+        status += " - تم الوصول للحد الأقصى";
+    }
+    statusLabel->setText(status);
+}
+
+void SPSearchPanel::onItemActivated(QTreeWidgetItem* item, int column) {
+    Q_UNUSED(column)
+    int line = item->data(0, Qt::UserRole + 1).toInt();
+    if (line < 0) return;
+
+    emit matchActivated(item->data(0, Qt::UserRole).toString(), line,
+                        item->data(0, Qt::UserRole + 2).toInt(),
+                        item->data(0, Qt::UserRole + 3).toInt());
+}
+
+void SPSearchPanel::updatePreview() {
+    previewing = !replaceInput->text().isEmpty() and previewPlan.prepare(lastQuery, replaceInput->text());
+
+    for (int i = 0; i < resultsTree->topLevelItemCount(); ++i) {
+        QTreeWidgetItem* fileItem = resultsTree->topLevelItem(i);
+        for (int j = 0; j < fileItem->childCount(); ++j) {
+            setMatchText(fileItem->child(j));
+        }
+    }
+}
+
+// عند كتابة نص الاستبدال يعرض كل سطر كما سيصبح، والسطر الأصلي في التلميح
+void SPSearchPanel::setMatchText(QTreeWidgetItem* item) const {
+    SPSearchMatch match{};
+    match.line = item->data(0, Qt::UserRole + 1).toInt();
+    match.column = item->data(0, Qt::UserRole + 2).toInt();
+    match.length = item->data(0, Qt::UserRole + 3).toInt();
+    match.lineText = item->data(0, Qt::UserRole + 4).toString();
+
+    if (previewing) {
+        item->setText(0, QString("%1: %2").arg(match.line + 1).arg(previewPlan.previewLine(match.lineText, match).trimmed()));
+        item->setToolTip(0, match.lineText.trimmed());
+    }
+    else {
+        item->setText(0, QString("%1: %2").arg(match.line + 1).arg(match.lineText.trimmed()));
+        item->setToolTip(0, QString());
+    }
+}
+
+void SPSearchPanel::requestReplace() {
+    QList<SPFileMatches> selected{};
+    for (int i = 0; i < resultsTree->topLevelItemCount(); ++i) {
+        QTreeWidgetItem* fileItem = resultsTree->topLevelItem(i);
+        if (fileItem->checkState(0) == Qt::Unchecked) continue;
+
+        SPFileMatches file{ fileItem->data(0, Qt::UserRole).toString() };
+        for (int j = 0; j < fileItem->childCount(); ++j) {
+            QTreeWidgetItem* matchItem = fileItem->child(j);
+            if (matchItem->checkState(0) != Qt::Checked) continue;
+            file.matches.append({ matchItem->data(0, Qt::UserRole + 1).toInt(),
+                                  matchItem->data(0, Qt::UserRole + 2).toInt(),
+                                  matchItem->data(0, Qt::UserRole + 3).toInt(),
+                                  matchItem->data(0, Qt::UserRole + 4).toString() });
+        }
+        if (!file.matches.isEmpty()) {
+            selected.append(file);
+        }
+    }
+    if (selected.isEmpty()) return;
+
+    replaceButton->setEnabled(false);
+    statusLabel->setText("جاري الاستبدال...");
+    emit replaceRequested(lastQuery, replaceInput->text(), selected);
+}
+
+void SPSearchPanel::replaceFinished(const SPReplaceResult& result) {
+    if (!result.ok) {
+        replaceButton->setEnabled(resultsTree->topLevelItemCount() > 0);
+        statusLabel->setText(result.strandedBackups.isEmpty() ? "فشل الاستبدال ولم يتغير أي ملف: " + result.error
+                                                              : "فشل الاستبدال: " + result.error);
+        return;
+    }
+
+    // المواضع المعروضة لم تعد صحيحة بعد تعديل الملفات
+    resultsTree->clear();
+    statusLabel->setText(QString("تم استبدال %1 تطابق في %2 ملف (%3 مللي ثانية)")
+                             .arg(result.replacements).arg(result.filesChanged).arg(result.elapsedMs));
+}
+
+QString SPSearchPanel::displayPath(const QString& filePath) const {
+    if (table and filePath.startsWith(table->rootPath() + '/')) {
+        return filePath.mid(table->rootPath().size() + 1);
+    }
+    return filePath;
+}
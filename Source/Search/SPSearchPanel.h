@@ -0,0 +1,62 @@
+#pragma once
+
+#include "SPFindInFiles.h"
+#include "SPProjectReplace.h"
+
+#include <QDockWidget>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QLabel>
+#include <QTreeWidget>
+#include <QHash>
+
+
+// لوحة البحث في المشروع، النتائج تظهر مجمعة حسب الملف أثناء البحث
+class SPSearchPanel : public QDockWidget {
+    Q_OBJECT
+
+public:
+    explicit SPSearchPanel(QWidget* parent = nullptr);
+
+    // openDocuments: المستندات المفتوحة ونصوصها الحالية
+    void setSearchSource(const SPPathTablePtr& table, const QHash<QString, QString>& openDocuments);
+    void focusInput();
+    void replaceFinished(const SPReplaceResult& result);
+
+signals:
+    // يطلب قبل كل بحث لكي تمرر النافذة الرئيسية أحدث فهرس ونصوص المستندات المفتوحة
+    void searchRequested();
+    void matchActivated(const QString& filePath, int line, int column, int length);
+    // المطابقات المحددة فقط، مجمعة حسب الملف ومرتبة كما في النتائج
+    void replaceRequested(const SPSearchQuery& query, const QString& replacement, const QList<SPFileMatches>& selected);
+
+private slots:
+    void startSearch();
+    void onResultsReady(const QList<SPFileMatches>& results);
+    void onSearchFinished(int filesSearched, int matchCount, qint64 elapsedMs, bool cancelled);
+    void onItemActivated(QTreeWidgetItem* item, int column);
+    void updatePreview();
+    void requestReplace();
+
+private:
+    QString displayPath(const QString& filePath) const;
+    void setMatchText(QTreeWidgetItem* item) const;
+
+    SPFindInFiles* engine{};
+    SPPathTablePtr table{};
+    QHash<QString, QString> openDocuments{};
+    SPSearchQuery lastQuery{};
+    SPReplacePlan previewPlan{};
+    bool previewing{};
+
+    QLineEdit* input{};
+    QLineEdit* replaceInput{};
+    QPushButton* replaceButton{};
+    QCheckBox* wholeWordCheck{};
+    QCheckBox* regexCheck{};
+    QCheckBox* caseCheck{};
+    QPushButton* searchButton{};
+    QLabel* statusLabel{};
+    QTreeWidget* resultsTree{};
+};
@@ -0,0 +1,90 @@
+#include "SPConfig.h"
+#include "SPTrace.h"
+
+#include <QSettings>
+#include <QtConcurrent/QtConcurrentRun>
+
+
+SPConfig::SPConfig() {
+    loading = QtConcurrent::run([]() {
+        SP_TRACE_SCOPE("config.load");
+        QSettings settings("Alif", "Spectrum");
+        QVariantHash result{};
+        for (const QString& key : settings.allKeys()) {
+            result.insert(key, settings.value(key));
+        }
+        return result;
+    });
+
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(flushDelayMs);
+    connect(flushTimer, &QTimer::timeout, this, &SPConfig::writeBatch);
+}
+
+SPConfig& SPConfig::instance() {
+    static SPConfig config{};
+    return config;
+}
+
+void SPConfig::ensureLoaded() const {
+    if (loaded) return;
+    values = loading.result();
+    loaded = true;
+}
+
+QVariant SPConfig::value(const QString& key, const QVariant& defaultValue) const {
+    ensureLoaded();
+    return values.value(key, defaultValue);
+}
+
+void SPConfig::setValue(const QString& key, const QVariant& value) {
+    ensureLoaded();
+    if (values.value(key) == value) return;
+
+    values.insert(key, value);
+    pending.insert(key, value);
+    flushTimer->start();
+
+    emit valueChanged(key, value);
+    if (key == editorFontSizeKey) emit editorFontSizeChanged(value.toInt());
+}
+
+int SPConfig::editorFontSize() const {
+    return value(editorFontSizeKey).toInt();
+}
+
+void SPConfig::setEditorFontSize(int size) {
+    setValue(editorFontSizeKey, size);
+}
+
+// كتابة واحدة في كل مرة لكي لا تسبق دفعة قديمة دفعة أحدث منها
+void SPConfig::writeBatch() {
+    if (pending.isEmpty()) return;
+    if (writing.isRunning()) {
+        flushTimer->start();
+        return;
+    }
+
+    QVariantHash changes = pending;
+    pending.clear();
+    writing = QtConcurrent::run(&SPConfig::writeValues, changes);
+}
+
+void SPConfig::flush() {
+    flushTimer->stop();
+    writing.waitForFinished();
+    if (!pending.isEmpty()) {
+        writeValues(pending);
+        pending.clear();
+    }
+}
+
+void SPConfig::writeValues(const QVariantHash& changes) {
+    SP_TRACE_SCOPE("config.write");
+    QSettings settings("Alif", "Spectrum");
+    for (auto it = changes.cbegin(); it != changes.cend(); ++it) {
+        settings.setValue(it.key(), it.value());
+    }
+    settings.sync();
+}
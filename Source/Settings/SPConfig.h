@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QObject>
+#include <QVariant>
+#include <QVariantHash>
+#include <QFuture>
+#include <QTimer>
+
+
+// خدمة الإعدادات المشتركة: تقرأ ملف الإعدادات مرة واحدة في خيط خلفي عند بدء البرنامج
+// وتخدم القيم من الذاكرة، وكل تغيير يرسل إشارة ويجمع مع غيره ثم يكتب في الخلفية
+// أول قراءة تنتظر التحميل إن لم ينته، وهو يبدأ قبل تحميل الخطوط فينتهي عادة قبلها
+class SPConfig : public QObject {
+    Q_OBJECT
+
+public:
+    static SPConfig& instance();
+
+    QVariant value(const QString& key, const QVariant& defaultValue = QVariant()) const;
+    void setValue(const QString& key, const QVariant& value);
+
+    int editorFontSize() const;
+    void setEditorFontSize(int size);
+
+    // يكتب التغييرات المتبقية وينتظرها، ويستدعى عند إغلاق البرنامج
+    void flush();
+
+    static constexpr int flushDelayMs = 500;
+    static constexpr const char* editorFontSizeKey = "editorFontSize";
+
+signals:
+    void valueChanged(const QString& key, const QVariant& value);
+    void editorFontSizeChanged(int size);
+
+private:
+    SPConfig();
+
+    void ensureLoaded() const;
+    void writeBatch();
+    static void writeValues(const QVariantHash& changes);
+
+    mutable QFuture<QVariantHash> loading{};
+    mutable QVariantHash values{};
+    mutable bool loaded{};
+
+    QVariantHash pending{};
+    QFuture<void> writing{};
+    QTimer* flushTimer{};
+};
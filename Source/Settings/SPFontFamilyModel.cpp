@@ -0,0 +1,63 @@
+#include "SPFontFamilyModel.h"
+
+#include <QApplication>
+#include <QFontDatabase>
+#include <QFont>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+
+SPFontFamilyModel::SPFontFamilyModel(QObject* parent) : QAbstractListModel(parent) {
+    watcher = new QFutureWatcher<QStringList>(this);
+    connect(watcher, &QFutureWatcher<QStringList>::finished, this, [this]() {
+        beginResetModel();
+        families = watcher->result();
+        loaded = true;
+        endResetModel();
+        emit familiesLoaded();
+    });
+}
+
+SPFontFamilyModel* SPFontFamilyModel::instance() {
+    static SPFontFamilyModel* model = new SPFontFamilyModel(qApp);
+    return model;
+}
+
+void SPFontFamilyModel::load() {
+    if (loaded or watcher->isRunning()) return;
+
+    watcher->setFuture(QtConcurrent::run([]() {
+        QStringList result = QFontDatabase::families();
+        std::sort(result.begin(), result.end(), [](const QString& a, const QString& b) {
+            return a.compare(b, Qt::CaseInsensitive) < 0;
+        });
+        return result;
+    }));
+}
+
+int SPFontFamilyModel::indexOf(const QString& family) const {
+    for (qsizetype i = 0; i < families.size(); ++i) {
+        if (families.at(i).compare(family, Qt::CaseInsensitive) == 0) return int(i);
+    }
+    return -1;
+}
+
+int SPFontFamilyModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : int(families.size());
+}
+
+QVariant SPFontFamilyModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() or index.row() >= families.size()) return QVariant();
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return families.at(index.row());
+    case Qt::FontRole:
+        // العرض يطلب هذا الدور للعناصر الظاهرة فقط
+        return QFont(families.at(index.row()));
+    default:
+        return QVariant();
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QFutureWatcher>
+#include <QStringList>
+
+
+// قائمة الخطوط المثبتة مرتبة، مشتركة بين كل النوافذ
+// تعداد الخطوط بطيء مع كثرتها، لذلك يتم مرة واحدة في خيط خلفي وقت الفراغ
+// ومعاينة كل خط تعطى عبر FontRole فلا يحمل الخط إلا عند رسم عنصره
+class SPFontFamilyModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    static SPFontFamilyModel* instance();
+
+    // يبدأ التعداد إن لم يبدأ من قبل، والنتيجة تصل بإعادة تعيين النموذج
+    void load();
+    bool isLoaded() const { return loaded; }
+    int indexOf(const QString& family) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+signals:
+    void familiesLoaded();
+
+private:
+    explicit SPFontFamilyModel(QObject* parent = nullptr);
+
+    QStringList families{};
+    QFutureWatcher<QStringList>* watcher{};
+    bool loaded{};
+};
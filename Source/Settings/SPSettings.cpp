@@ -5,7 +5,6 @@ SPSettings::SPSettings(QWidget* parent) : QWidget(parent) {
     setWindowTitle("الإعدادات");
     setWindowFlags(Qt::Window | Qt::WindowCloseButtonHint);
     setMinimumSize(800, 600);
-    setStyleSheet("color: #dddddd; background-color: #1e202e;");
 
     // Layout setup
     QHBoxLayout* mainLayout = new QHBoxLayout();
@@ -24,7 +23,6 @@ SPSettings::SPSettings(QWidget* parent) : QWidget(parent) {
     optionsLayout->setSpacing(0);
 
     QWidget* optionsWidget = new QWidget();
-    optionsWidget->setStyleSheet(".QWidget { border-left-width: 3px; border-left-style: ridge; border-left-color: #1e202f; }");
     optionsWidget->setLayout(optionsLayout);
     optionsWidget->setMinimumWidth(200);
     optionsWidget->setMaximumWidth(300);
@@ -33,7 +31,12 @@ SPSettings::SPSettings(QWidget* parent) : QWidget(parent) {
     propertyWidget->setLayout(mainPropertyLayout);
     propertyWidget->setMinimumWidth(400);
 
+    QFrame* optionsSeparator = new QFrame();
+    optionsSeparator->setFrameShape(QFrame::VLine);
+    optionsSeparator->setFrameShadow(QFrame::Sunken);
+
     mainLayout->addWidget(optionsWidget);
+    mainLayout->addWidget(optionsSeparator);
     mainLayout->addWidget(stackedWidget);
 
     mainPropertyLayout->addLayout(buttonLayout);
@@ -42,15 +45,6 @@ SPSettings::SPSettings(QWidget* parent) : QWidget(parent) {
 }
 
 
-void SPSettings::closeEvent(QCloseEvent* event) {
-    QSettings settings("Alif", "Spectrum");
-    settings.setValue("editorFontSize", fontSpin->value());
-
-    // emit windowClosed();
-    // event->accept();
-}
-
-
 void SPSettings::switchPage() {
     SPFlatButton* btn = qobject_cast<SPFlatButton*>(sender());
     if (btn) {
@@ -60,9 +54,10 @@ void SPSettings::switchPage() {
         // Update button states
         for (SPFlatButton* category : categories) {
             bool active = (category == btn);
-            category->setStyleSheet(active ?
-                                        "font-weight: bold; color: #10a8f4;" :
-                                        "");
+            QFont font = category->font();
+            font.setWeight(active ? QFont::Bold : QFont::Thin);
+            category->setFont(font);
+            category->setForegroundRole(active ? QPalette::Link : QPalette::ButtonText);
         }
     }
 }
@@ -84,7 +79,8 @@ void SPSettings::createCategory(const QString& name, const QString& description)
     // Add description label
     QLabel* descLabel = new QLabel(description);
     descLabel->setWordWrap(true);
-    descLabel->setStyleSheet("color: #888; margin-bottom: 20px;");
+    descLabel->setForegroundRole(QPalette::PlaceholderText);
+    descLabel->setContentsMargins(0, 0, 0, 20);
     pageLayout->addWidget(descLabel);
 
     // Add category-specific content
@@ -102,8 +98,6 @@ void SPSettings::createCategory(const QString& name, const QString& description)
 void SPSettings::createAppearancePage(QVBoxLayout* layout) {
     // Font selection
     QGroupBox* fontGroup = new QGroupBox("الخط");
-    fontGroup->setStyleSheet("QGroupBox { border: 1px solid gray; border-radius: 6px; margin-top: 2.0ex;}"
-                             " QGroupBox::title { subcontrol-origin: margin; padding: 0 2px; left: 10px; }");
     QVBoxLayout* fontLayout = new QVBoxLayout(fontGroup);
     QFormLayout* fontSizeLayout = new QFormLayout();
     QFormLayout* fontFamilyLayout = new QFormLayout();
@@ -113,12 +107,13 @@ void SPSettings::createAppearancePage(QVBoxLayout* layout) {
     fontSpin->setMinimumHeight(40);
     fontSpin->setMaximumWidth(80);
 
-    QSettings settingsVal("Alif", "Spectrum");
-    int savedSize = settingsVal.value("editorFontSize").toInt();
-    fontSpin->setValue(savedSize);
+    SPConfig& config = SPConfig::instance();
+    fontSpin->setValue(config.editorFontSize());
 
     fontSizeLayout->addRow("حجم الخط: ", fontSpin);
-    connect(fontSpin, &QSpinBox::valueChanged, this, &SPSettings::fontSizeChanged);
+    // القيمة تحفظ وتصل إلى كل المحررات عبر خدمة الإعدادات
+    connect(fontSpin, &QSpinBox::valueChanged, &config, &SPConfig::setEditorFontSize);
+    connect(&config, &SPConfig::editorFontSizeChanged, fontSpin, &QSpinBox::setValue);
 
 
     QComboBox* fontCombo = new QComboBox();
@@ -126,14 +121,24 @@ void SPSettings::createAppearancePage(QVBoxLayout* layout) {
     fontCombo->setInsertPolicy(QComboBox::NoInsert);
     fontCombo->setMinimumHeight(40);
     fontCombo->setMaximumWidth(200);
-
-    QStringList fontFamilies = QFontDatabase::families();
-    fontFamilies.sort(Qt::CaseInsensitive);
-    // Add fonts to combobox
-    foreach (const QString &family, fontFamilies) {
-        fontCombo->addItem(family);
+    // الحجم لا يحسب من كل العناصر، والقائمة لا تقيس كل سطر، فلا يحمل خط إلا عند ظهوره
+    fontCombo->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    fontCombo->setMinimumContentsLength(16);
+    if (QListView* fontView = qobject_cast<QListView*>(fontCombo->view())) {
+        fontView->setUniformItemSizes(true);
     }
+
+    // قائمة الخطوط مشتركة وتملأ في الخلفية، والنص الحالي لا يحتاج انتظارها لأن القائمة قابلة للكتابة
+    SPFontFamilyModel* familyModel = SPFontFamilyModel::instance();
+    fontCombo->setModel(familyModel);
+    familyModel->load();
     fontCombo->setCurrentText("Arial");
+    // إعادة تعيين النموذج عند اكتمال القائمة تغير العنصر الحالي، فيعاد تحديده
+    connect(familyModel, &SPFontFamilyModel::familiesLoaded, fontCombo, [fontCombo, familyModel]() {
+        int row = familyModel->indexOf("Arial");
+        if (row != -1) fontCombo->setCurrentIndex(row);
+        else fontCombo->setCurrentText("Arial");
+    });
 
     fontFamilyLayout->addRow("نوع الخط: ", fontCombo);
 
@@ -141,4 +146,24 @@ void SPSettings::createAppearancePage(QVBoxLayout* layout) {
     // fontLayout->addLayout(fontFamilyLayout);
 
     layout->addWidget(fontGroup);
+
+    // السمة تحفظ في الإعدادات، ومحرك السمات يطبقها فور تغيرها
+    QGroupBox* themeGroup = new QGroupBox("السمة");
+    QFormLayout* themeLayout = new QFormLayout(themeGroup);
+
+    QComboBox* themeCombo = new QComboBox();
+    themeCombo->addItems(SPTheme::themeNames());
+    themeCombo->setCurrentText(SPTheme::instance().name());
+    themeCombo->setMinimumHeight(40);
+    themeCombo->setMaximumWidth(200);
+    themeLayout->addRow("سمة الألوان: ", themeCombo);
+
+    connect(themeCombo, &QComboBox::currentTextChanged, &config, [&config](const QString& name) {
+        config.setValue(SPTheme::themeKey, name);
+    });
+    connect(&SPTheme::instance(), &SPTheme::themeChanged, themeCombo, [themeCombo]() {
+        themeCombo->setCurrentText(SPTheme::instance().name());
+    });
+
+    layout->addWidget(themeGroup);
 }
@@ -1,4 +1,7 @@
 #include "FlatButton.h"
+#include "SPFontFamilyModel.h"
+#include "SPConfig.h"
+#include "SPTheme.h"
 
 #include <QMainWindow>
 #include <QWidget>
@@ -6,25 +9,22 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
-#include <QSettings>
 #include <QCloseEvent>
 #include <QStackedWidget>
 #include <QGroupBox>
 #include <QComboBox>
 #include <QSpinBox>
 #include <QFontDatabase>
+#include <QListView>
 #include <QFormLayout>
+#include <QFrame>
 
 class SPSettings : public QWidget {
     Q_OBJECT
 public:
     explicit SPSettings(QWidget* parent = nullptr);
 
-protected:
-    void closeEvent(QCloseEvent* event) override;
-
 signals:
-    void fontSizeChanged(int size);
     // void settingsChanged();
     // void windowClosed();
 
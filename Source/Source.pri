@@ -0,0 +1,96 @@
+# ملفات المحرر المشتركة بين البرنامج وأدوات القياس
+# البرنامج وأدوات القياس تضم هذا الملف، فيبقى كل ملف جديد في قائمة واحدة
+
+INCLUDEPATH += \
+    $$PWD/TextEditor \
+    $$PWD/MenuBar \
+    $$PWD/Settings \
+    $$PWD/FoldersTree \
+    $$PWD/Project \
+    $$PWD/QuickOpen \
+    $$PWD/Search \
+    $$PWD/Instrumentation \
+    $$PWD/Diff \
+    $$PWD/Git \
+    $$PWD/Instance \
+    $$PWD/Theme \
+    $$PWD/Fonts \
+    $$PWD/Components \
+
+SOURCES += \
+    $$PWD/TextEditor/AlifComplete.cpp \
+    $$PWD/TextEditor/AlifLexer.cpp \
+    $$PWD/TextEditor/SPEditor.cpp \
+    $$PWD/TextEditor/SPHighlighter.cpp \
+    $$PWD/TextEditor/SPDocumentLayout.cpp \
+    $$PWD/TextEditor/SPLayoutCache.cpp \
+    $$PWD/MenuBar/SPMenu.cpp \
+    $$PWD/Settings/SPSettings.cpp \
+    $$PWD/Settings/SPFontFamilyModel.cpp \
+    $$PWD/Settings/SPConfig.cpp \
+    $$PWD/FoldersTree/SPFolders.cpp \
+    $$PWD/FoldersTree/SPProjectTreeModel.cpp \
+    $$PWD/Project/SPIgnoreRules.cpp \
+    $$PWD/Project/SPFileWatcher.cpp \
+    $$PWD/Project/SPFileCache.cpp \
+    $$PWD/Project/SPProjectIndex.cpp \
+    $$PWD/QuickOpen/SPFuzzyMatcher.cpp \
+    $$PWD/QuickOpen/SPQuickOpen.cpp \
+    $$PWD/Search/SPFindInFiles.cpp \
+    $$PWD/Search/SPSearchPanel.cpp \
+    $$PWD/Search/SPProjectReplace.cpp \
+    $$PWD/Instrumentation/SPInstrumentation.cpp \
+    $$PWD/Instrumentation/SPInstrumentationPanel.cpp \
+    $$PWD/Instrumentation/SPStartupTrace.cpp \
+    $$PWD/Instrumentation/SPFrameStats.cpp \
+    $$PWD/Instrumentation/SPFrameHud.cpp \
+    $$PWD/Instrumentation/SPTrace.cpp \
+    $$PWD/Instrumentation/SPWatchdog.cpp \
+    $$PWD/Instrumentation/SPMemory.cpp \
+    $$PWD/Diff/SPLineDiff.cpp \
+    $$PWD/Diff/SPDiffView.cpp \
+    $$PWD/Git/SPGitStatus.cpp \
+    $$PWD/Instance/SPSingleInstance.cpp \
+    $$PWD/Theme/SPTheme.cpp \
+    $$PWD/Theme/SPProxyStyle.cpp \
+    $$PWD/Fonts/SPFonts.cpp \
+    $$PWD/Components/FlatButton.cpp \
+
+HEADERS += \
+    $$PWD/TextEditor/AlifComplete.h \
+    $$PWD/TextEditor/AlifLexer.h \
+    $$PWD/TextEditor/SPEditor.h \
+    $$PWD/TextEditor/SPHighlighter.h \
+    $$PWD/TextEditor/SPDocumentLayout.h \
+    $$PWD/TextEditor/SPLayoutCache.h \
+    $$PWD/MenuBar/SPMenu.h \
+    $$PWD/Settings/SPSettings.h \
+    $$PWD/Settings/SPFontFamilyModel.h \
+    $$PWD/Settings/SPConfig.h \
+    $$PWD/FoldersTree/SPFolders.h \
+    $$PWD/FoldersTree/SPProjectTreeModel.h \
+    $$PWD/Project/SPIgnoreRules.h \
+    $$PWD/Project/SPFileWatcher.h \
+    $$PWD/Project/SPFileCache.h \
+    $$PWD/Project/SPProjectIndex.h \
+    $$PWD/QuickOpen/SPFuzzyMatcher.h \
+    $$PWD/QuickOpen/SPQuickOpen.h \
+    $$PWD/Search/SPFindInFiles.h \
+    $$PWD/Search/SPSearchPanel.h \
+    $$PWD/Search/SPProjectReplace.h \
+    $$PWD/Instrumentation/SPInstrumentation.h \
+    $$PWD/Instrumentation/SPInstrumentationPanel.h \
+    $$PWD/Instrumentation/SPStartupTrace.h \
+    $$PWD/Instrumentation/SPFrameStats.h \
+    $$PWD/Instrumentation/SPFrameHud.h \
+    $$PWD/Instrumentation/SPTrace.h \
+    $$PWD/Instrumentation/SPWatchdog.h \
+    $$PWD/Instrumentation/SPMemory.h \
+    $$PWD/Diff/SPLineDiff.h \
+    $$PWD/Diff/SPDiffView.h \
+    $$PWD/Git/SPGitStatus.h \
+    $$PWD/Instance/SPSingleInstance.h \
+    $$PWD/Theme/SPTheme.h \
+    $$PWD/Theme/SPProxyStyle.h \
+    $$PWD/Fonts/SPFonts.h \
+    $$PWD/Components/FlatButton.h \
@@ -11,22 +11,6 @@ Terminal::Terminal(QWidget* parent)
 {
     setWindowTitle("الطرفية");
     setFont(QFont("Tajawal"));
-    setStyleSheet(R"(
-        QDockWidget {
-            color: #dddddd;
-            border: none;
-            titlebar-close-icon: url(:/Resources/close.png);
-        }
-        QDockWidget::title {
-            background-color: #1e202e;
-            border: none;
-            padding: 3px 5px 0 0;
-        }
-        QDockWidget::close-button {
-            icon-size: 10px;
-        }
-    )");
-
     setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetClosable);
 
     // Create terminal display
@@ -51,13 +35,9 @@ Terminal::Terminal(QWidget* parent)
 
 void Terminal::setupTerminalDisplay() {
     terminalDisplay->setReadOnly(false);
-    terminalDisplay->setStyleSheet(R"(
-        QPlainTextEdit {
-            background-color: #141520;
-            color: white;
-            font-family: Consolas, monospace;
-        }
-    )");
+    QFont font("Consolas");
+    font.setStyleHint(QFont::Monospace);
+    terminalDisplay->setFont(font);
 }
 
 bool Terminal::eventFilter(QObject* obj, QEvent* event) {
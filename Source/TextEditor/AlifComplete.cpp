@@ -1,4 +1,6 @@
 #include "AlifComplete.h"
+#include "SPTheme.h"
+#include "SPTrace.h"
 
 #include <QVBoxLayout>
 #include <QCoreApplication>
@@ -12,162 +14,197 @@
 
 AutoComplete::AutoComplete(QPlainTextEdit* editor, QObject* parent)
     : QObject(parent), editor(editor) {
-    keywords = QStringList()
-               << "اطبع"
-               << "اذا"
-               << "اواذا"
-               << "استمر"
-               << "ارجع"
-               << "استورد"
-               << "احذف"
-               << "ادخل"
-               << "اصل"
-               << "او"
-               << "انتظر"
-
-               << "بينما"
-
-               << "توقف"
-
-               << "حاول"
-
-               << "خطأ"
-               << "خلل"
-
-               << "دالة"
-
-               << "صنف"
-               << "صح"
-               << "صحيح"
-
-               << "عدم"
-               << "عند"
-               << "عام"
-               << "عشري"
-
-               << "في"
-
-               << "ك"
-
-               << "لاجل"
-               << "ليس"
-
-               << "مرر"
-               << "من"
-               << "مزامنة"
-               << "مدى"
-               << "مصفوفة"
-
-               << "نطاق"
-               << "نهاية"
-
-               << "هل"
-
-               << "والا"
-               << "ولد"
-               << "و"
-
-               << "_تهيئة_";
-
-    shortcuts = {
-        {"اطبع", "اطبع($1)"},
-        {"اذا", "اذا $1:\n\t\nوالا:\n\t"},
-        {"اواذا", "اواذا $1:\n\t"},
-        {"استمر", "استمر"},
-        {"ارجع", "ارجع $1"},
-        {"استورد", "استورد $1"},
-        {"احذف", "احذف $1"},
-        {"ادخل", "ادخل($1)"},
-        {"اصل", "اصل()._تهيئة_($1)"},
-        {"او", "او"},
-        {"انتظر", "انتظر"},
-        {"بينما", "بينما $1:\n\t"},
-        {"توقف", "توقف"},
-        {"حاول", "حاول:\n\t\nخلل:\n\t\nنهاية:\n\t"},
-        {"خطأ", "خطأ"},
-        {"خلل", "خلل:\n\t"},
-        {"دالة", "دالة $1():\n\t"},
-        {"صنف", "صنف $1:\n\tدالة _تهيئة_(هذا):\n\t\t"},
-        {"صح", "صح"},
-        {"صحيح", "صحيح($1)"},
-        {"عدم", "عدم"},
-        {"عند", "عند $1 ك :\n\t"},
-        {"عام", "عام $1"},
-        {"عشري", "عشري($1)"},
-        {"في", "في"},
-        {"ك", "ك"},
-        {"لاجل", "لاجل $1 في :\n\t"},
-        {"ليس", "ليس"},
-        {"مرر", "مرر"},
-        {"من", "من $1 استورد "},
-        {"مزامنة", "مزامنة"},
-        {"مدى", "مدى($1)"},
-        {"مصفوفة", "مصفوفة($1)"},
-        {"نطاق", "نطاق $1"},
-        {"نهاية", "نهاية $1:\n\t"},
-        {"هل", "هل"},
-        {"والا", "والا:\n\t$1"},
-        {"ولد", "ولد $1"},
-        {"و", "و"},
-        {"_تهيئة_", "دالة _تهيئة_(هذا):\n\t"}
-    };        
-    descriptions = {
-        {"اطبع", "لعرض قيمة في الطرفية."},
-        {"اذا", "تنفيذ أمر في حال تحقق الشرط."},
-        {"اواذا", "التحقق من شرط إضافي بعد الشرط 'اذا'."},
-        {"استمر", "الانتقال إلى التكرار التالي."},
-        {"ارجع", "إرجاع قيمة من دالة."},
-        {"استورد", "تضمين مكتبة خارجية."},
-        {"احذف", "حذف متغير من الذاكرة."},
-        {"ادخل", "قراءة مدخل من المستخدم."},
-        {"اصل", "تستخدم لتهيئة الصنف الموروث."},
-        {"او", "يكفي تحقق أحد الشرطين."},
-        {"انتظر", "تتوقف الدالة عن التنفيذ الى حين قدوم النتائج."},
-        {"بينما", "حلقة تعمل طالما أن الشرط صحيح."},
-        {"توقف", "إيقاف تنفيذ تكرار الحلقة."},
-        {"حاول", "محاولة تنفيذ الشفرة فإن ظهر خلل تنتقل إلى تنفيذ مرحلة'خلل'."},
-        {"خطأ", "قيمة منطقية تدل على أن الشرط غير محقق."},
-        {"خلل", "يتم تنفيذها في حال ظهور خلل ما في مرحلة تنفيذ 'حاول'."},
-        {"دالة", "تعريف دالة جديدة تحتوي برنامج يتم تنفيذه عند استدعائها."},
-        {"صنف", "إنشاء كائن يمتلك صفات ودوال."},
-        {"صح", "قيمة منطقية تدل على أن الشرط محقق."},
-        {"صحيح", "دالة ضمنية تقوم بتحويل المعامل الممرر الى عدد صحيح."},
-        {"عدم", "قيمة فارغة."},
-        {"عند", "تستخدم لفتح ملف خارجي والكتابة والقراءة عليه."},
-        {"عام", "إخبار النطاق الداخلي أن هذا المتغير عام."},
-        {"عشري", "دالة ضمنية تقوم بتحويل المعامل الممرر الى عدد عشري."},
-        {"في", "تقوم بالتحقق ما إذا كانت القيمة ضمن حاوية مثل المصفوفة."},
-        {"ك", "تحدد اسم الملف البديل عند فتحه."},
-        {"لاجل", "حلقة تكرار ضمن مدى من الاعداد او مجموعة عناصر حاوية كالمصفوفة."},
-        {"ليس", "نفي شرط أو قيمة."},
-        {"مرر", "لا تقم بعمل شيء."},
-        {"من", "تستخدم لاستيراد جزء محدد من ملف كاستيراد دالة واحدة."},
-        {"مزامنة", "تجعل الدالة تزامنية بحيث تتوقف لإنتظار النتائج."},
-        {"مدى", "تحديد مدى عددي من وإلى والخطوات."},
-        {"مصفوفة", "دالة ضمنية تقوم بتحويل المعامل الممرر الى مصفوفة."},
-        {"نطاق", "إخبار النطاق الداخلي أن هذا المتغير في نطاق اعلى ولكنه ليس عام."},
-        {"نهاية", "يتم تنفيذ هذه الحالة بعد الإنتهاء من حالة 'حاول' مهما كانت النتيجة."},
-        {"هل", "تستخدم للتحقق من قيمتين إن كانتا متطابقتين في النوع."},
-        {"والا", "في حال عدم تحقق شرط 'اذا' يتم تنفيذها."},
-        {"ولد", "تقوم بإرجاع قيم متتالية من دالة."},
-        {"و", "أي يجب تحقق الشرطين معًا."},
-        {"_تهيئة_", "دالة تقوم بتهيئة الصنف بشكل تلقائي عند استدعائه."},
-    };    
+    connect(editor, &QPlainTextEdit::textChanged, this, &AutoComplete::showCompletion);
+
+    // filters
+    editor->installEventFilter(this);
+}
+
+// الكلمات والاختصارات والأوصاف ثابتة، فتبنى مرة واحدة وتتشاركها كل المحررات
+const AutoComplete::Tables& AutoComplete::tables() {
+    static const Tables shared = []() {
+        Tables tables{};
+        tables.keywords = QStringList()
+                   << "اطبع"
+                   << "اذا"
+                   << "اواذا"
+                   << "استمر"
+                   << "ارجع"
+                   << "استورد"
+                   << "احذف"
+                   << "ادخل"
+                   << "اصل"
+                   << "او"
+                   << "انتظر"
+
+                   << "بينما"
+
+                   << "توقف"
+
+                   << "حاول"
+
+                   << "خطأ"
+                   << "خلل"
+
+                   << "دالة"
+
+                   << "صنف"
+                   << "صح"
+                   << "صحيح"
+
+                   << "عدم"
+                   << "عند"
+                   << "عام"
+                   << "عشري"
+
+                   << "في"
+
+                   << "ك"
+
+                   << "لاجل"
+                   << "ليس"
+
+                   << "مرر"
+                   << "من"
+                   << "مزامنة"
+                   << "مدى"
+                   << "مصفوفة"
+
+                   << "نطاق"
+                   << "نهاية"
+
+                   << "هل"
+
+                   << "والا"
+                   << "ولد"
+                   << "و"
+
+                   << "_تهيئة_";
+
+        tables.shortcuts = {
+            {"اطبع", "اطبع($1)"},
+            {"اذا", "اذا $1:\n\t\nوالا:\n\t"},
+            {"اواذا", "اواذا $1:\n\t"},
+            {"استمر", "استمر"},
+            {"ارجع", "ارجع $1"},
+            {"استورد", "استورد $1"},
+            {"احذف", "احذف $1"},
+            {"ادخل", "ادخل($1)"},
+            {"اصل", "اصل()._تهيئة_($1)"},
+            {"او", "او"},
+            {"انتظر", "انتظر"},
+            {"بينما", "بينما $1:\n\t"},
+            {"توقف", "توقف"},
+            {"حاول", "حاول:\n\t\nخلل:\n\t\nنهاية:\n\t"},
+            {"خطأ", "خطأ"},
+            {"خلل", "خلل:\n\t"},
+            {"دالة", "دالة $1():\n\t"},
+            {"صنف", "صنف $1:\n\tدالة _تهيئة_(هذا):\n\t\t"},
+            {"صح", "صح"},
+            {"صحيح", "صحيح($1)"},
+            {"عدم", "عدم"},
+            {"عند", "عند $1 ك :\n\t"},
+            {"عام", "عام $1"},
+            {"عشري", "عشري($1)"},
+            {"في", "في"},
+            {"ك", "ك"},
+            {"لاجل", "لاجل $1 في :\n\t"},
+            {"ليس", "ليس"},
+            {"مرر", "مرر"},
+            {"من", "من $1 استورد "},
+            {"مزامنة", "مزامنة"},
+            {"مدى", "مدى($1)"},
+            {"مصفوفة", "مصفوفة($1)"},
+            {"نطاق", "نطاق $1"},
+            {"نهاية", "نهاية $1:\n\t"},
+            {"هل", "هل"},
+            {"والا", "والا:\n\t$1"},
+            {"ولد", "ولد $1"},
+            {"و", "و"},
+            {"_تهيئة_", "دالة _تهيئة_(هذا):\n\t"}
+        };        
+        tables.descriptions = {
+            {"اطبع", "لعرض قيمة في الطرفية."},
+            {"اذا", "تنفيذ أمر في حال تحقق الشرط."},
+            {"اواذا", "التحقق من شرط إضافي بعد الشرط 'اذا'."},
+            {"استمر", "الانتقال إلى التكرار التالي."},
+            {"ارجع", "إرجاع قيمة من دالة."},
+            {"استورد", "تضمين مكتبة خارجية."},
+            {"احذف", "حذف متغير من الذاكرة."},
+            {"ادخل", "قراءة مدخل من المستخدم."},
+            {"اصل", "تستخدم لتهيئة الصنف الموروث."},
+            {"او", "يكفي تحقق أحد الشرطين."},
+            {"انتظر", "تتوقف الدالة عن التنفيذ الى حين قدوم النتائج."},
+            {"بينما", "حلقة تعمل طالما أن الشرط صحيح."},
+            {"توقف", "إيقاف تنفيذ تكرار الحلقة."},
+            {"حاول", "محاولة تنفيذ الشفرة فإن ظهر خلل تنتقل إلى تنفيذ مرحلة'خلل'."},
+            {"خطأ", "قيمة منطقية تدل على أن الشرط غير محقق."},
+            {"خلل", "يتم تنفيذها في حال ظهور خلل ما في مرحلة تنفيذ 'حاول'."},
+            {"دالة", "تعريف دالة جديدة تحتوي برنامج يتم تنفيذه عند استدعائها."},
+            {"صنف", "إنشاء كائن يمتلك صفات ودوال."},
+            {"صح", "قيمة منطقية تدل على أن الشرط محقق."},
+            {"صحيح", "دالة ضمنية تقوم بتحويل المعامل الممرر الى عدد صحيح."},
+            {"عدم", "قيمة فارغة."},
+            {"عند", "تستخدم لفتح ملف خارجي والكتابة والقراءة عليه."},
+            {"عام", "إخبار النطاق الداخلي أن هذا المتغير عام."},
+            {"عشري", "دالة ضمنية تقوم بتحويل المعامل الممرر الى عدد عشري."},
+            {"في", "تقوم بالتحقق ما إذا كانت القيمة ضمن حاوية مثل المصفوفة."},
+            {"ك", "تحدد اسم الملف البديل عند فتحه."},
+            {"لاجل", "حلقة تكرار ضمن مدى من الاعداد او مجموعة عناصر حاوية كالمصفوفة."},
+            {"ليس", "نفي شرط أو قيمة."},
+            {"مرر", "لا تقم بعمل شيء."},
+            {"من", "تستخدم لاستيراد جزء محدد من ملف كاستيراد دالة واحدة."},
+            {"مزامنة", "تجعل الدالة تزامنية بحيث تتوقف لإنتظار النتائج."},
+            {"مدى", "تحديد مدى عددي من وإلى والخطوات."},
+            {"مصفوفة", "دالة ضمنية تقوم بتحويل المعامل الممرر الى مصفوفة."},
+            {"نطاق", "إخبار النطاق الداخلي أن هذا المتغير في نطاق اعلى ولكنه ليس عام."},
+            {"نهاية", "يتم تنفيذ هذه الحالة بعد الإنتهاء من حالة 'حاول' مهما كانت النتيجة."},
+            {"هل", "تستخدم للتحقق من قيمتين إن كانتا متطابقتين في النوع."},
+            {"والا", "في حال عدم تحقق شرط 'اذا' يتم تنفيذها."},
+            {"ولد", "تقوم بإرجاع قيم متتالية من دالة."},
+            {"و", "أي يجب تحقق الشرطين معًا."},
+            {"_تهيئة_", "دالة تقوم بتهيئة الصنف بشكل تلقائي عند استدعائه."},
+        };
+        return tables;
+    }();
+    return shared;
+}
+
+const QStringList& AutoComplete::keywords() {
+    return tables().keywords;
+}
+
+qsizetype AutoComplete::memoryUsage() {
+    // كل نص يحمل رأساً صغيراً فوق أحرفه، وكل عنصر في الخريطة عقدة
+    constexpr qsizetype stringHeader = 24;
+    constexpr qsizetype mapNode = 48;
+    auto size = [](const QString& text) { return text.capacity() * qsizetype(sizeof(QChar)) + stringHeader; };
+
+    const Tables& shared = tables();
+    qsizetype bytes = shared.keywords.capacity() * qsizetype(sizeof(QString));
+    for (const QString& keyword : shared.keywords) bytes += size(keyword);
+    for (const QMap<QString, QString>* map : { &shared.shortcuts, &shared.descriptions }) {
+        for (auto it = map->cbegin(); it != map->cend(); ++it) bytes += size(it.key()) + size(it.value()) + mapNode;
+    }
+    return bytes;
+}
+
+// النافذة المنبثقة وأنماطها تبنى عند أول حاجة إليها أو عند التهيئة المسبقة في وقت الفراغ
+void AutoComplete::ensurePopup() {
+    if (popup) return;
 
     popup = new QWidget(editor, Qt::ToolTip | Qt::FramelessWindowHint);
-    popup->setStyleSheet(
-        "QWidget { background-color: #242533; color: #cccccc; }"
-        "QListWidget { background-color: #242533; color: #cccccc; }"
-        "QListWidget::item { padding: 7px; }"
-        "QListWidget::item:selected { background-color: #3a3d54; color: #10a8f4; padding: 0 12px 0 0; }");
+    SPTheme::usePopupPalette(popup);
+    popup->setAutoFillBackground(true);
 
     QVBoxLayout* popupLayout = new QVBoxLayout(popup);
     popupLayout->setContentsMargins(0, 0, 0, 0);
 
     listWidget = new QListWidget(popup);
+    listWidget->setSpacing(3);
 
     QLabel* descriptionLabel = new QLabel(popup);
-    descriptionLabel->setStyleSheet("color: #cccccc; padding: 3px;");
+    descriptionLabel->setContentsMargins(3, 3, 3, 3);
     descriptionLabel->setWordWrap(true);
 
     // set layouts
@@ -179,24 +216,28 @@ AutoComplete::AutoComplete(QPlainTextEdit* editor, QObject* parent)
     connect(listWidget, &QListWidget::currentItemChanged, this,
             [=](QListWidgetItem* current, QListWidgetItem* previos) {
         if (!current) return;
-        QString desc = descriptions.value(current->text(), QString());
+        QString desc = tables().descriptions.value(current->text(), QString());
         if (desc.isEmpty()) {
             return;
         }
         descriptionLabel->setText(desc);
     });
-    connect(editor, &QPlainTextEdit::textChanged, this, &AutoComplete::showCompletion);
     connect(listWidget, &QListWidget::itemClicked, this, &AutoComplete::insertCompletion);
+}
 
-    // filters
-    editor->installEventFilter(this);
+void AutoComplete::warmUp() {
+    tables();
+    ensurePopup();
+    popup->ensurePolished();
+    listWidget->ensurePolished();
 }
 
 
+
 bool AutoComplete::eventFilter(QObject* obj, QEvent* event) {
     if (obj == editor and event->type() == QEvent::KeyPress) {
         QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
-        if (popup->isVisible()) {
+        if (popup and popup->isVisible()) {
             if (keyEvent->key() == Qt::Key_Tab
                 or keyEvent->key() == Qt::Key_Return
                 or keyEvent->key() == Qt::Key_Enter) {
@@ -216,7 +257,7 @@ bool AutoComplete::eventFilter(QObject* obj, QEvent* event) {
     } else if (event->type() == QEvent::FocusOut) { // review
         QTimer::singleShot(0, this, [this]() {
             QWidget* newFocus = QApplication::focusWidget();
-            if (!newFocus || !popup->isAncestorOf(newFocus)) {
+            if (popup and (!newFocus || !popup->isAncestorOf(newFocus))) {
                 popup->hide();
             }
         });
@@ -231,6 +272,13 @@ QString AutoComplete::getCurrentWord() const {
 }
 
 void AutoComplete::showCompletion() {
+    SP_TRACE_SCOPE("showCompletion");
+    // المحرر للقراءة فقط (مثل عرض الفروق) لا يقترح شيئاً
+    if (editor->isReadOnly()) {
+        hidePopup();
+        return;
+    }
+
     QString currentWord = getCurrentWord();
     if (currentWord.isEmpty() or currentWord.length() < 1) {
         hidePopup();
@@ -238,13 +286,14 @@ void AutoComplete::showCompletion() {
     }
 
     QStringList suggestions{};
-    for (const QString& keyword : keywords) {
+    for (const QString& keyword : tables().keywords) {
         if (keyword.startsWith(currentWord, Qt::CaseInsensitive)) {
             suggestions << keyword;
         }
     }
 
     if (!suggestions.isEmpty()) {
+        ensurePopup();
         listWidget->clear();
         listWidget->addItems(suggestions);
         listWidget->setCurrentRow(0);
@@ -291,19 +340,19 @@ void AutoComplete::showPopup() {
 }
 
 inline void AutoComplete::hidePopup() {
-    popup->hide();
+    if (popup) popup->hide();
 }
 
 void AutoComplete::insertCompletion() {
-    if (!popup->isVisible()) return;
+    if (!popup or !popup->isVisible()) return;
 
     QListWidgetItem* item = listWidget->currentItem();
     if (!item) return;
 
     QString word = item->text();
-    if (!shortcuts.contains(word)) return;
+    if (!tables().shortcuts.contains(word)) return;
 
-    QString text = shortcuts.value(word);
+    QString text = tables().shortcuts.value(word);
     QTextCursor cursor = editor->textCursor();
     cursor.movePosition(QTextCursor::PreviousWord, QTextCursor::KeepAnchor);
     cursor.removeSelectedText();
@@ -311,7 +360,7 @@ void AutoComplete::insertCompletion() {
     placeholderPositions.clear();
 
     // البحث عن جميع العلامات مثل $1 وغيرها
-    QRegularExpression re("\\$(\\d+)");
+    static const QRegularExpression re("\\$(\\d+)");
     QRegularExpressionMatchIterator i = re.globalMatch(text);
     QList<QPair<int, int>> matches;
 
@@ -349,5 +398,5 @@ void AutoComplete::insertCompletion() {
 
 
 bool AutoComplete::isPopupVisible() {
-    return popup->isVisible();
+    return popup and popup->isVisible();
 }
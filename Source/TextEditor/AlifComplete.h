@@ -13,6 +13,12 @@ public:
     explicit AutoComplete(QPlainTextEdit* editor, QObject* parent = nullptr);
 
     bool isPopupVisible();
+    // يبني النافذة المنبثقة مسبقاً لكي لا يتأخر ظهورها أول مرة
+    void warmUp();
+    // الكلمات المفتاحية للغة ألف، وتستخدم أيضاً في تهيئة أشكال الحروف
+    static const QStringList& keywords();
+    // حجم جداول الإكمال المشتركة بين كل المحررات
+    static qsizetype memoryUsage();
 
 protected:
     bool eventFilter(QObject* obj, QEvent* event) override;
@@ -22,14 +28,19 @@ private slots:
     void insertCompletion();
 
 private:
+    struct Tables {
+        QStringList keywords{};
+        QMap<QString, QString> shortcuts{};
+        QMap<QString, QString> descriptions{};
+    };
+    static const Tables& tables();
+
     QPlainTextEdit* editor{};
     QWidget* popup{};
     QListWidget* listWidget{};
-    QStringList keywords{};
-    QMap<QString, QString> shortcuts;
-    QMap<QString, QString> descriptions;
     QList<int> placeholderPositions;
 
+    void ensurePopup();
     QString getCurrentWord() const;
     void showPopup();
     inline void hidePopup();
@@ -0,0 +1,60 @@
+#include "SPDocumentLayout.h"
+#include "SPLayoutCache.h"
+#include "SPFrameStats.h"
+
+#include <QTextDocument>
+#include <QTextLayout>
+#include <QElapsedTimer>
+
+
+SPDocumentLayout::SPDocumentLayout(QTextDocument* document)
+    : QPlainTextDocumentLayout(document) {}
+
+QRectF SPDocumentLayout::blockBoundingRect(const QTextBlock& block) const {
+    if (!block.isValid()) {
+        return QPlainTextDocumentLayout::blockBoundingRect(block);
+    }
+
+    // السطر يحمل سجل تخطيطه، وكل تخطيط يمر من هنا يحتفظ بأشكال حروفه ما دام في الذاكرة المؤقتة
+    QTextBlock target = block;
+    QTextLayout* layout = target.layout();
+    SPLayoutEntry* entry = static_cast<SPLayoutEntry*>(target.userData());
+    SPLayoutCache& cache = SPLayoutCache::instance();
+
+    if (entry and entry->cached and entry->generation == generation and layout->lineCount()) {
+        cache.touch(entry);
+        return QPlainTextDocumentLayout::blockBoundingRect(block);
+    }
+
+    // تخطيط من جيل خط أقدم، أو سطر لم يسجل بعد أو أخرج من الذاكرة المؤقتة: يخطط من جديد
+    if (layout->lineCount()) {
+        layout->clearLayout();
+    }
+    layout->setCacheEnabled(true);
+
+    QElapsedTimer timer{};
+    timer.start();
+    QRectF rect = QPlainTextDocumentLayout::blockBoundingRect(block);
+    qint64 shapingNs = timer.nsecsElapsed();
+    SPFrameStats::countRelayout();
+
+    if (!entry) {
+        entry = new SPLayoutEntry(layout, document());
+        target.setUserData(entry);
+    }
+    entry->generation = generation;
+    cache.insert(entry, block.length(), shapingNs);
+    return rect;
+}
+
+void SPDocumentLayout::documentChanged(int from, int charsRemoved, int charsAdded) {
+    if (!fontChanging) {
+        QPlainTextDocumentLayout::documentChanged(from, charsRemoved, charsAdded);
+        return;
+    }
+
+    // عدد الأسطر لم يتغير، وعدد الأسطر الملتفة يبقى تقديرياً حتى يعاد تخطيط كل سطر
+    // كما يفعل التخطيط الأساسي عند تفريغ التخطيطات
+    ++generation;
+    emit update(QRectF(0., -document()->documentMargin(), 1000000000., 1000000000.));
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QPlainTextDocumentLayout>
+#include <QTextBlock>
+
+
+// تخطيط المستند مع تغيير خط كسول: تغيير الخط لا يمر على كل أسطر المستند
+// بل يرفع رقم الجيل، وكل سطر يعاد تخطيطه عند أول طلب لحدوده إن كان تخطيطه من جيل أقدم
+// والمحرر يطلب حدود الأسطر الظاهرة أولاً، فلا يخطط غيرها إلا عند ظهوره
+// الأسطر المخططة هنا تحتفظ بنتائج تشكيلها عبر SPLayoutCache، وبيانات المستخدم للسطر محجوزة لسجلها
+class SPDocumentLayout : public QPlainTextDocumentLayout {
+    Q_OBJECT
+
+public:
+    explicit SPDocumentLayout(QTextDocument* document);
+
+    // يغلف تغيير خط المستند، وما يصل من تغييرات بينهما يعامل كتغيير في الخط فقط
+    void beginFontChange() { fontChanging = true; }
+    void endFontChange() { fontChanging = false; }
+
+    QRectF blockBoundingRect(const QTextBlock& block) const override;
+
+protected:
+    void documentChanged(int from, int charsRemoved, int charsAdded) override;
+
+private:
+    quint32 generation{};
+    bool fontChanging{};
+};
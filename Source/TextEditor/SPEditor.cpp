@@ -1,18 +1,27 @@
 #include "SPEditor.h"
+#include "SPTrace.h"
 
 #include <QPainter>
+#include <QPainterPath>
 #include <QTextBlock>
 #include <QScrollBar>
 #include <QMimeData>
-#include <QSettings>
+#include <QTimer>
+
+#include <algorithm>
 
 SPEditor::SPEditor(QWidget* parent) {
     setAcceptDrops(true);
-    this->setStyleSheet("QPlainTextEdit { background-color: #141520; color: #cccccc; }");
     this->setTabStopDistance(32);
 
+    // تخطيط يؤجل إعادة تخطيط الأسطر غير الظاهرة عند تغيير الخط
+    QTextDocument* editorDocument = new QTextDocument(this);
+    documentLayout = new SPDocumentLayout(editorDocument);
+    editorDocument->setDocumentLayout(documentLayout);
+    editorDocument->setDefaultFont(font());
+    setDocument(editorDocument);
+
     // set "force" cursor and text direction from right to left
-    QTextDocument* editorDocument = this->document();
     QTextOption option = editorDocument->defaultTextOption();
     option.setTextDirection(Qt::RightToLeft);
     option.setAlignment(Qt::AlignRight);
@@ -30,23 +39,56 @@ SPEditor::SPEditor(QWidget* parent) {
     updateLineNumberAreaWidth();
     highlightCurrentLine();
 
-    // load saved font size
-    QSettings settingsVal("Alif", "Spectrum");
-    int savedSize = settingsVal.value("editorFontSize").toInt();
-    updateFontSize(savedSize);
+    // تغييرات الحجم المتتالية تجمع، فيطبق آخرها مرة كل فترة قصيرة
+    fontSizeTimer = new QTimer(this);
+    fontSizeTimer->setSingleShot(true);
+    fontSizeTimer->setInterval(fontSizeIntervalMs);
+    connect(fontSizeTimer, &QTimer::timeout, this, &SPEditor::applyFontSize);
+
+    // load saved font size, and follow later changes from the settings window
+    pendingFontSize = SPConfig::instance().editorFontSize();
+    applyFontSize();
+    connect(&SPConfig::instance(), &SPConfig::editorFontSizeChanged, this, &SPEditor::updateFontSize);
+
+    // الخلفية والنص من لوحة الألوان، ولون السطر الحالي وأرقام الأسطر من السمة
+    connect(&SPTheme::instance(), &SPTheme::themeChanged, this, [this]() {
+        highlightCurrentLine();
+        lineNumberArea->update();
+    });
 
     // Handle special key events
     installEventFilter(this); // for SHIFT + ENTER it's make line without number
 }
 
 void SPEditor::updateFontSize(int size) {
+    pendingFontSize = size;
+    if (!fontSizeTimer->isActive()) {
+        fontSizeTimer->start();
+    }
+}
+
+void SPEditor::applyFontSize() {
+    int size = pendingFontSize;
+    if (font().pointSize() == size) return;
+
     QFont font = this->font(); // Get current font
     font.setPointSize(size);
+    // المستند لا يعيد تخطيط كل أسطره، بل تتقادم تخطيطاتها وتعاد عند ظهورها
+    documentLayout->beginFontChange();
     this->setFont(font);
+    documentLayout->endFontChange();
 
     QFont fontNums = lineNumberArea->font();
     fontNums.setPointSize(size - 4);
     lineNumberArea->setFont(fontNums);
+    updateLineNumberAreaWidth();
+
+    layoutVisibleBlocks();
+
+    // الحجم الجديد يهيأ بعد انتهاء الحدث الحالي، والأحجام المهيأة سابقاً لا تعاد
+    if (fontsWarmed) {
+        QTimer::singleShot(0, this, &SPEditor::warmUpFonts);
+    }
 }
 
 bool SPEditor::eventFilter(QObject* obj, QEvent* event) {
@@ -59,8 +101,8 @@ bool SPEditor::eventFilter(QObject* obj, QEvent* event) {
             }
         }
         // Handle Shift+Return or Shift+Enter
-        if (keyEvent->key() == Qt::Key_Return
-             or keyEvent->key() == Qt::Key_Enter) {
+        if ((keyEvent->key() == Qt::Key_Return
+             or keyEvent->key() == Qt::Key_Enter) and !isReadOnly()) {
             if (keyEvent->modifiers() & Qt::ShiftModifier) {
                 return true; // Event handled
             }
@@ -114,24 +156,85 @@ void SPEditor::resizeEvent(QResizeEvent* event) {
         areaWidth,
         cr.height()
     ));
+
+    if (frameHud) {
+        frameHud->move(viewport()->geometry().topLeft() + QPoint(8, 8));
+    }
+}
+
+void SPEditor::paintEvent(QPaintEvent* event) {
+    {
+        SPFrameStats::Scope scope(SPFrameStats::EditorPaint);
+        QPlainTextEdit::paintEvent(event);
+    }
+    SPFrameStats::endFrame();
+}
+
+void SPEditor::setFrameHudVisible(bool visible) {
+    if (!frameHud) {
+        if (!visible) return;
+        frameHud = new SPFrameHud(this);
+        frameHud->move(viewport()->geometry().topLeft() + QPoint(8, 8));
+    }
+    frameHud->setVisible(visible);
+    frameHud->raise();
+}
+
+bool SPEditor::isFrameHudVisible() const {
+    return frameHud and frameHud->isVisible();
 }
 
 
 void SPEditor::lineNumberAreaPaintEvent(QPaintEvent* event) {
+    SPFrameStats::Scope scope(SPFrameStats::GutterPaint);
+    SP_TRACE_SCOPE("lineNumberAreaPaintEvent");
     QPainter painter(lineNumberArea);
     painter.fillRect(event->rect(), Qt::transparent);
 
+    const SPThemeColors& colors = SPTheme::instance().colors();
+
+    // حد أيسر بزاويتين مستديرتين يفصل الأرقام عن النص
+    QRectF area = QRectF(lineNumberArea->rect()).adjusted(0.5, 0.5, -0.5, -0.5);
+    QPainterPath border{};
+    border.moveTo(area.left() + 9, area.top());
+    border.arcTo(QRectF(area.left(), area.top(), 18, 18), 90, 90);
+    border.lineTo(area.left(), area.bottom() - 9);
+    border.arcTo(QRectF(area.left(), area.bottom() - 18, 18, 18), 180, 90);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(colors.accent);
+    painter.drawPath(border);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
     QTextBlock block = firstVisibleBlock();
     int blockNumber = block.blockNumber();
     int top = qRound(blockBoundingGeometry(block).translated(contentOffset()).top());
     int bottom = top + qRound(blockBoundingRect(block).height());
 
+    // العلامات مرتبة حسب السطر، فيبدأ البحث من أول علامة تصل إلى السطر الظاهر الأول
+    auto marker = std::lower_bound(lineMarkers.cbegin(), lineMarkers.cend(), blockNumber,
+                                   [](const SPLineMarker& item, int line) {
+                                       return item.line + qMax(item.count, 1) <= line;
+                                   });
+
     while (block.isValid() and top <= event->rect().bottom()) {
         if (block.isVisible() and bottom >= event->rect().top()) {
             QString number = QString::number(blockNumber + 1);
-            painter.setPen(QColor(200, 200, 200));
+            painter.setPen(colors.lineNumber);
             painter.drawText(12, top, lineNumberArea->width(), fontMetrics().height(),
                              Qt::AlignRight | Qt::AlignVCenter, number);
+
+            while (marker != lineMarkers.cend() and marker->line + qMax(marker->count, 1) <= blockNumber) {
+                ++marker;
+            }
+            if (marker != lineMarkers.cend() and marker->line <= blockNumber) {
+                if (marker->kind == SPLineMarker::Deleted) {
+                    painter.fillRect(0, top - 1, 8, 3, colors.gitDeleted);
+                }
+                else {
+                    QColor color = marker->kind == SPLineMarker::Added ? colors.gitAdded : colors.gitModified;
+                    painter.fillRect(0, top, 3, bottom - top, color);
+                }
+            }
         }
 
         block = block.next();
@@ -144,13 +247,48 @@ void SPEditor::lineNumberAreaPaintEvent(QPaintEvent* event) {
 
 
 
+// الأسطر الظاهرة تخطط فوراً بالحجم الجديد، فيكون الرسم التالي جاهزاً
+void SPEditor::layoutVisibleBlocks() {
+    QTextBlock block = firstVisibleBlock();
+    qreal top = contentOffset().y() + blockBoundingGeometry(block).top();
+    qreal bottom = viewport()->height();
+    while (block.isValid() and top <= bottom) {
+        top += blockBoundingRect(block).height();
+        block = block.next();
+    }
+}
+
+void SPEditor::warmUp() {
+    autoComplete->warmUp();
+    warmUpFonts();
+}
+
+void SPEditor::warmUpFonts() {
+    fontsWarmed = true;
+    SPFonts::warmUp(font(), AutoComplete::keywords());
+    SPFonts::warmUp(lineNumberArea->font());
+}
+
+void SPEditor::setLineMarkers(const QList<SPLineMarker>& markers) {
+    if (markers.isEmpty() and lineMarkers.isEmpty()) return;
+    lineMarkers = markers;
+    lineNumberArea->update();
+}
+
+void SPEditor::setDiffSelections(const QList<QTextEdit::ExtraSelection>& selections) {
+    if (selections.isEmpty() and diffSelections.isEmpty()) return;
+    diffSelections = selections;
+    highlightCurrentLine();
+}
+
 void SPEditor::highlightCurrentLine() {
-    QList<QTextEdit::ExtraSelection> extraSelections;
+    SPFrameStats::Scope scope(SPFrameStats::ExtraSelections);
+    QList<QTextEdit::ExtraSelection> extraSelections = diffSelections;
 
     if (!isReadOnly()) {
         QTextEdit::ExtraSelection selection;
 
-        QColor lineColor = QColor(23, 24, 36, 240);
+        QColor lineColor = SPTheme::instance().colors().currentLine;
 
         selection.format.setBackground(lineColor);
         selection.format.setProperty(QTextFormat::FullWidthSelection, true);
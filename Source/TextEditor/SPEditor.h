@@ -2,6 +2,12 @@
 
 #include "SPHighlighter.h"
 #include "AlifComplete.h"
+#include "SPLineDiff.h"
+#include "SPDocumentLayout.h"
+#include "SPConfig.h"
+#include "SPTheme.h"
+#include "SPFonts.h"
+#include "SPFrameHud.h"
 
 
 class LineNumberArea;
@@ -17,12 +23,22 @@ public:
 
     QString getCurrentLineIndentation(const QTextCursor &cursor) const;
     void curserIndentation();
+    // يبني مكونات الإكمال التلقائي ويهيئ أشكال حروف الخطوط مسبقاً في وقت الفراغ
+    void warmUp();
+    bool isFrameHudVisible() const;
 
 public slots:
     void updateFontSize(int);
+    // علامات الفروق عن HEAD بجانب أرقام الأسطر
+    void setLineMarkers(const QList<SPLineMarker>& markers);
+    // تلوين إضافي يبقى تحت تلوين السطر الحالي، مثل أسطر الفروق
+    void setDiffSelections(const QList<QTextEdit::ExtraSelection>& selections);
+    // طبقة أزمنة الرسم فوق المحرر، تنشأ عند أول إظهار
+    void setFrameHudVisible(bool visible);
 
 protected:
     void resizeEvent(QResizeEvent* event) override;
+    void paintEvent(QPaintEvent* event) override;
     bool eventFilter(QObject* obj, QEvent* event) override;
 
     void dragEnterEvent(QDragEnterEvent* event) override;
@@ -34,6 +50,19 @@ private:
     SyntaxHighlighter* highlighter{};
     AutoComplete* autoComplete{};
     LineNumberArea* lineNumberArea{};
+    QList<SPLineMarker> lineMarkers{};
+    QList<QTextEdit::ExtraSelection> diffSelections{};
+    bool fontsWarmed{};
+    SPDocumentLayout* documentLayout{};
+    SPFrameHud* frameHud{};
+    QTimer* fontSizeTimer{};
+    int pendingFontSize{};
+
+    static constexpr int fontSizeIntervalMs = 40;
+
+    void warmUpFonts();
+    void applyFontSize();
+    void layoutVisibleBlocks();
 
 private slots:
     void updateLineNumberAreaWidth();
@@ -48,15 +77,6 @@ signals:
 class LineNumberArea : public QWidget {
 public:
     LineNumberArea(SPEditor* editor) : QWidget(editor), spEditor(editor) {
-        this->setStyleSheet(
-            "QWidget {"
-            "   border-left: 1px solid #10a8f4;"
-            "   border-top-left-radius: 9px;"        // Rounded top-left corner
-            "   border-bottom-left-radius: 9px;"     // Rounded bottom-left corner
-            "}"
-        );
-
-
 #if defined(Q_OS_WIN)
         QString fontName = "Kawkab-Mono";
 #elif defined(Q_OS_LINUX) or defined(Q_OS_MAC)
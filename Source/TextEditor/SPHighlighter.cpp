@@ -1,4 +1,5 @@
 #include "SPHighlighter.h"
+#include "SPTrace.h"
 
 
 SyntaxHighlighter::SyntaxHighlighter(QTextDocument* parent)
@@ -6,6 +7,7 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument* parent)
 }
 
 void SyntaxHighlighter::highlightBlock(const QString& text) {
+    SP_TRACE_SCOPE("highlightBlock");
     Lexer lexer{};
     QVector<Token> tokens = lexer.tokenize(text);
 
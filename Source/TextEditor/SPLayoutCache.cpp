@@ -0,0 +1,93 @@
+#include "SPLayoutCache.h"
+
+
+SPLayoutEntry::~SPLayoutEntry() {
+    SPLayoutCache::instance().remove(this);
+}
+
+
+SPLayoutCache& SPLayoutCache::instance() {
+    static SPLayoutCache cache{};
+    return cache;
+}
+
+void SPLayoutCache::touch(SPLayoutEntry* entry) {
+    ++counters.hits;
+    if (!entry->cached or entry == head) return;
+
+    unlink(entry);
+    pushFront(entry);
+}
+
+void SPLayoutCache::insert(SPLayoutEntry* entry, qsizetype chars, qint64 shapingNs) {
+    ++counters.misses;
+    counters.shapingNs += shapingNs;
+
+    if (entry->cached) unlink(entry);
+    entry->chars = chars;
+    entry->lines = entry->layout->lineCount();
+    entry->formats = int(entry->layout->formats().size());
+    pushFront(entry);
+    evict();
+}
+
+void SPLayoutCache::remove(SPLayoutEntry* entry) {
+    if (entry->cached) unlink(entry);
+}
+
+void SPLayoutCache::pushFront(SPLayoutEntry* entry) {
+    entry->cached = true;
+    entry->previous = nullptr;
+    entry->next = head;
+    if (head) head->previous = entry;
+    head = entry;
+    if (!tail) tail = entry;
+
+    counters.chars += entry->chars;
+    ++counters.lines;
+
+    DocumentUsage& usage = documents[entry->document];
+    usage.lines += entry->lines;
+    usage.formats += entry->formats;
+}
+
+void SPLayoutCache::unlink(SPLayoutEntry* entry) {
+    if (entry->previous) entry->previous->next = entry->next;
+    else head = entry->next;
+    if (entry->next) entry->next->previous = entry->previous;
+    else tail = entry->previous;
+
+    entry->previous = nullptr;
+    entry->next = nullptr;
+    entry->cached = false;
+    counters.chars -= entry->chars;
+    --counters.lines;
+
+    auto usage = documents.find(entry->document);
+    if (usage == documents.end()) return;
+    usage->lines -= entry->lines;
+    usage->formats -= entry->formats;
+    if (usage->lines <= 0 and usage->formats <= 0) documents.erase(usage);
+}
+
+void SPLayoutCache::evict() {
+    // السطر الخارج يعود إلى التخطيط العادي: يحذف أشكاله الآن ويعاد تخطيطه عند طلبه
+    while (counters.chars > counters.budget and tail and tail != head) {
+        SPLayoutEntry* entry = tail;
+        unlink(entry);
+        ++counters.evictions;
+
+        QTextLayout* layout = entry->layout;
+        layout->setCacheEnabled(false);
+        layout->beginLayout();
+        layout->endLayout();
+    }
+}
+
+SPLayoutCache::Stats SPLayoutCache::stats() const {
+    return counters;
+}
+
+SPLayoutCache::DocumentUsage SPLayoutCache::documentUsage(const QTextDocument* document) const {
+    return documents.value(document);
+}
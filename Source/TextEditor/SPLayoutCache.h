@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QTextBlock>
+#include <QTextLayout>
+#include <QHash>
+
+
+// سجل تخطيط السطر، يحمله السطر نفسه فيحذف معه ويخرج من الذاكرة المؤقتة تلقائياً
+class SPLayoutEntry : public QTextBlockUserData {
+public:
+    SPLayoutEntry(QTextLayout* layout, const QTextDocument* document) : layout(layout), document(document) {}
+    ~SPLayoutEntry() override;
+
+    QTextLayout* layout{};
+    quint32 generation{};   // جيل الخط الذي خطط به السطر
+
+private:
+    friend class SPLayoutCache;
+    SPLayoutEntry* previous{};
+    SPLayoutEntry* next{};
+    const QTextDocument* document{};
+    qsizetype chars{};
+    int lines{};            // الأسطر الملتفة وتنسيقات التلوين عند التخطيط، لمحاسبة الذاكرة
+    int formats{};
+    bool cached{};
+};
+
+
+// ذاكرة مؤقتة لنتائج تشكيل الأسطر (تحليل الاتجاه وتشكيل HarfBuzz) على مستوى البرنامج
+// تخطيط السطر يحتفظ بأشكال حروفه بدل رميها بعد التخطيط، فالرسم عند التمرير والتلوين لا يعيد التشكيل
+// المفتاح فعلياً هو نص السطر وتنسيقاته والخط والعرض: Qt يفرغ تخطيط السطر عند تغير أي منها فيعاد التشكيل
+// الحجم محدود بعدد الأحرف، والأقدم استخداماً يرجع إلى التخطيط بدون احتفاظ. تستخدم من خيط الواجهة فقط
+class SPLayoutCache {
+public:
+    static SPLayoutCache& instance();
+
+    // سطر مخطط استخدم مرة أخرى بدون تشكيل
+    void touch(SPLayoutEntry* entry);
+    // سطر خطط الآن، ويضاف إلى أول القائمة
+    void insert(SPLayoutEntry* entry, qsizetype chars, qint64 shapingNs);
+    void remove(SPLayoutEntry* entry);
+
+    struct Stats {
+        quint64 hits{};
+        quint64 misses{};
+        quint64 evictions{};
+        qint64 shapingNs{};
+        qsizetype chars{};
+        qsizetype budget{};
+        int lines{};
+    };
+    Stats stats() const;
+
+    // الأسطر المخططة لمستند واحد، تحدث مع كل إضافة وإخراج فلا يمر على أسطر المستند
+    struct DocumentUsage {
+        qsizetype lines{};
+        qsizetype formats{};
+    };
+    DocumentUsage documentUsage(const QTextDocument* document) const;
+
+    static constexpr qsizetype defaultBudget = 512 * 1024;
+
+private:
+    SPLayoutCache() = default;
+
+    void pushFront(SPLayoutEntry* entry);
+    void unlink(SPLayoutEntry* entry);
+    void evict();
+
+    SPLayoutEntry* head{};
+    SPLayoutEntry* tail{};
+    Stats counters{ .budget = defaultBudget };
+    QHash<const QTextDocument*, DocumentUsage> documents{};
+};
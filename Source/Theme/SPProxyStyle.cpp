@@ -0,0 +1,200 @@
+#include "SPProxyStyle.h"
+#include "SPTheme.h"
+
+#include <QPainter>
+#include <QStyleOption>
+
+
+// شريط التمرير العمودي فقط له شكل خاص، والأفقي يبقى على النمط الأساسي
+static const QStyleOptionSlider* verticalScrollBar(const QStyleOption* option) {
+    const QStyleOptionSlider* bar = qstyleoption_cast<const QStyleOptionSlider*>(option);
+    return bar and bar->orientation == Qt::Vertical ? bar : nullptr;
+}
+
+
+SPProxyStyle::SPProxyStyle(QStyle* style)
+    : QProxyStyle(style),
+    closeIcon(":/icons/Resources/close.png"),
+    upArrow(":/icons/Resources/up-arrow.png"),
+    downArrow(":/icons/Resources/down-arrow.png") {}
+
+void SPProxyStyle::drawPrimitive(PrimitiveElement element, const QStyleOption* option,
+                                 QPainter* painter, const QWidget* widget) const {
+    const SPThemeColors& colors = SPTheme::instance().colors();
+
+    switch (element) {
+    case PE_IndicatorDockWidgetResizeHandle:
+        painter->fillRect(option->rect, option->state & State_MouseOver ? colors.separatorHover
+                                                                         : colors.separator);
+        return;
+
+    case PE_FrameLineEdit: {
+        painter->save();
+        painter->setRenderHint(QPainter::Antialiasing);
+        painter->setPen(option->state & State_HasFocus ? colors.accent : colors.border);
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRoundedRect(QRectF(option->rect).adjusted(0.5, 0.5, -0.5, -0.5), 3, 3);
+        painter->restore();
+        return;
+    }
+
+    case PE_PanelMenu:
+        painter->fillRect(option->rect, option->palette.window());
+        return;
+
+    case PE_FrameMenu: {
+        // حد سفلي وأيسر فقط كما كان في القوائم
+        QRect rect = option->rect;
+        painter->fillRect(rect.left(), rect.top(), 1, rect.height(), colors.accent);
+        painter->fillRect(rect.left(), rect.bottom(), rect.width(), 1, colors.accent);
+        return;
+    }
+
+    default:
+        QProxyStyle::drawPrimitive(element, option, painter, widget);
+    }
+}
+
+void SPProxyStyle::drawControl(ControlElement element, const QStyleOption* option,
+                               QPainter* painter, const QWidget* widget) const {
+    const SPThemeColors& colors = SPTheme::instance().colors();
+
+    switch (element) {
+    case CE_DockWidgetTitle:
+        if (const QStyleOptionDockWidget* title = qstyleoption_cast<const QStyleOptionDockWidget*>(option)) {
+            painter->fillRect(title->rect, colors.surface);
+            QRect textRect = title->rect.adjusted(5, 3, -5, 0);
+            QString text = title->fontMetrics.elidedText(title->title, Qt::ElideRight, textRect.width());
+            drawItemText(painter, textRect,
+                         visualAlignment(title->direction, Qt::AlignLeft | Qt::AlignVCenter) | Qt::TextShowMnemonic,
+                         title->palette, title->state & State_Enabled, text, QPalette::WindowText);
+            return;
+        }
+        break;
+
+    case CE_MenuBarEmptyArea:
+        painter->fillRect(option->rect, option->palette.window());
+        return;
+
+    case CE_MenuBarItem:
+        if (const QStyleOptionMenuItem* item = qstyleoption_cast<const QStyleOptionMenuItem*>(option)) {
+            QColor background = colors.surface;
+            if (item->state & State_Sunken) background = colors.border.lighter(115);
+            else if (item->state & State_Selected) background = colors.border;
+            painter->fillRect(item->rect, background);
+            drawItemText(painter, item->rect,
+                         Qt::AlignCenter | Qt::TextShowMnemonic | Qt::TextDontClip | Qt::TextSingleLine,
+                         item->palette, item->state & State_Enabled, item->text, QPalette::WindowText);
+            return;
+        }
+        break;
+
+    case CE_MenuItem:
+        if (const QStyleOptionMenuItem* item = qstyleoption_cast<const QStyleOptionMenuItem*>(option)) {
+            if (item->menuItemType == QStyleOptionMenuItem::Separator) {
+                QRect rect = item->rect;
+                painter->fillRect(rect.left() + 15, rect.center().y(), rect.width() - 25, 1, colors.border);
+                return;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    QProxyStyle::drawControl(element, option, painter, widget);
+}
+
+void SPProxyStyle::drawComplexControl(ComplexControl control, const QStyleOptionComplex* option,
+                                      QPainter* painter, const QWidget* widget) const {
+    const QStyleOptionSlider* bar = control == CC_ScrollBar ? verticalScrollBar(option) : nullptr;
+    if (!bar) {
+        QProxyStyle::drawComplexControl(control, option, painter, widget);
+        return;
+    }
+
+    // المجرى شفاف، والمقبض مستدير، والسهمان صورتان في طرفي الشريط
+    const SPThemeColors& colors = SPTheme::instance().colors();
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    if (bar->maximum > bar->minimum) {
+        QRect handle = subControlRect(control, bar, SC_ScrollBarSlider, widget);
+        bool active = bar->activeSubControls & SC_ScrollBarSlider
+                      and bar->state & (State_MouseOver | State_Sunken);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(active ? colors.scrollHandleHover : colors.scrollHandle);
+        painter->drawRoundedRect(handle, 4, 4);
+    }
+
+    QRect subLine = subControlRect(control, bar, SC_ScrollBarSubLine, widget);
+    QRect addLine = subControlRect(control, bar, SC_ScrollBarAddLine, widget);
+    QSize arrowSize(12, 12);
+    upArrow.paint(painter, QRect(subLine.center() - QPoint(6, 6), arrowSize));
+    downArrow.paint(painter, QRect(addLine.center() - QPoint(6, 6), arrowSize));
+
+    painter->restore();
+}
+
+QRect SPProxyStyle::subControlRect(ComplexControl control, const QStyleOptionComplex* option,
+                                   SubControl subControl, const QWidget* widget) const {
+    const QStyleOptionSlider* bar = control == CC_ScrollBar ? verticalScrollBar(option) : nullptr;
+    if (!bar) return QProxyStyle::subControlRect(control, option, subControl, widget);
+
+    QRect rect = bar->rect;
+    int grooveInset = scrollArrowExtent + 2;
+    QRect groove = rect.adjusted(scrollBarMargin, grooveInset, -scrollBarMargin, -grooveInset);
+
+    // طول المقبض يتناسب مع الجزء الظاهر من المحتوى
+    int range = bar->maximum - bar->minimum;
+    int length = groove.height();
+    int handleLength = length;
+    if (range > 0) {
+        handleLength = int(qint64(length) * bar->pageStep / (qint64(range) + bar->pageStep));
+        handleLength = qMin(length, qMax(scrollHandleMinimum, handleLength));
+    }
+    int handleOffset = sliderPositionFromValue(bar->minimum, bar->maximum, bar->sliderPosition,
+                                               length - handleLength, bar->upsideDown);
+    QRect handle(groove.left(), groove.top() + handleOffset, groove.width(), handleLength);
+
+    switch (subControl) {
+    case SC_ScrollBarSubLine:
+        return QRect(rect.left(), rect.top(), rect.width(), scrollArrowExtent);
+    case SC_ScrollBarAddLine:
+        return QRect(rect.left(), rect.bottom() - scrollArrowExtent + 1, rect.width(), scrollArrowExtent);
+    case SC_ScrollBarGroove:
+        return groove;
+    case SC_ScrollBarSlider:
+        return handle;
+    case SC_ScrollBarSubPage:
+        return QRect(groove.left(), groove.top(), groove.width(), handle.top() - groove.top());
+    case SC_ScrollBarAddPage:
+        return QRect(groove.left(), handle.bottom() + 1, groove.width(), groove.bottom() - handle.bottom());
+    default:
+        return QRect();
+    }
+}
+
+int SPProxyStyle::pixelMetric(PixelMetric metric, const QStyleOption* option, const QWidget* widget) const {
+    switch (metric) {
+    case PM_ScrollBarExtent:
+        if (verticalScrollBar(option)) return scrollBarExtent;
+        break;
+    case PM_DockWidgetSeparatorExtent:
+        return 4;
+    case PM_MenuPanelWidth:
+        return 1;
+    default:
+        break;
+    }
+    return QProxyStyle::pixelMetric(metric, option, widget);
+}
+
+QIcon SPProxyStyle::standardIcon(StandardPixmap standardIcon, const QStyleOption* option,
+                                 const QWidget* widget) const {
+    if (standardIcon == SP_DockWidgetCloseButton or standardIcon == SP_TitleBarCloseButton) {
+        return closeIcon;
+    }
+    return QProxyStyle::standardIcon(standardIcon, option, widget);
+}
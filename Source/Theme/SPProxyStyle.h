@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QProxyStyle>
+#include <QIcon>
+
+
+// العناصر التي لا تكفيها لوحة الألوان: شريط التمرير، عناوين الألواح وفواصلها، حقول الإدخال والقوائم
+// الألوان تقرأ من السمة الحالية وقت الرسم، فلا يحتاج النمط إلى إعادة تثبيت عند تغيير السمة
+class SPProxyStyle : public QProxyStyle {
+    Q_OBJECT
+
+public:
+    explicit SPProxyStyle(QStyle* style = nullptr);
+
+    void drawPrimitive(PrimitiveElement element, const QStyleOption* option,
+                       QPainter* painter, const QWidget* widget = nullptr) const override;
+    void drawControl(ControlElement element, const QStyleOption* option,
+                     QPainter* painter, const QWidget* widget = nullptr) const override;
+    void drawComplexControl(ComplexControl control, const QStyleOptionComplex* option,
+                            QPainter* painter, const QWidget* widget = nullptr) const override;
+    QRect subControlRect(ComplexControl control, const QStyleOptionComplex* option,
+                         SubControl subControl, const QWidget* widget = nullptr) const override;
+    int pixelMetric(PixelMetric metric, const QStyleOption* option = nullptr,
+                    const QWidget* widget = nullptr) const override;
+    QIcon standardIcon(StandardPixmap standardIcon, const QStyleOption* option = nullptr,
+                       const QWidget* widget = nullptr) const override;
+
+private:
+    QIcon closeIcon{};
+    QIcon upArrow{};
+    QIcon downArrow{};
+
+    static constexpr int scrollBarExtent = 20;
+    static constexpr int scrollBarMargin = 6;
+    static constexpr int scrollArrowExtent = 16;
+    static constexpr int scrollHandleMinimum = 15;
+};
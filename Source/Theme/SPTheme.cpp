@@ -0,0 +1,147 @@
+#include "SPTheme.h"
+#include "SPProxyStyle.h"
+#include "SPConfig.h"
+
+#include <QApplication>
+#include <QStyleFactory>
+#include <QWidget>
+
+
+SPTheme::SPTheme() {
+    // كل لوحات الألوان تحسب مرة واحدة، والتبديل بينها لا يحسب شيئاً
+    for (const QString& name : themeNames()) {
+        palettes.insert(name, paletteFor(colorsFor(name)));
+    }
+
+    connect(&SPConfig::instance(), &SPConfig::valueChanged, this,
+            [this](const QString& key, const QVariant& value) {
+        if (key == themeKey) apply(value.toString());
+    });
+}
+
+SPTheme& SPTheme::instance() {
+    static SPTheme theme{};
+    return theme;
+}
+
+QStringList SPTheme::themeNames() {
+    return { "داكن", "فاتح" };
+}
+
+void SPTheme::apply(const QString& name) {
+    QString themeName = themeNames().contains(name) ? name : themeNames().first();
+    if (styleInstalled and themeName == current) return;
+
+    current = themeName;
+    themeColors = colorsFor(themeName);
+
+    // النمط يقرأ الألوان وقت الرسم، فيكفي تثبيته مرة واحدة
+    if (!styleInstalled) {
+        QApplication::setStyle(new SPProxyStyle(QStyleFactory::create("Fusion")));
+        styleInstalled = true;
+    }
+    QApplication::setPalette(palettes.value(themeName));
+
+    emit themeChanged();
+}
+
+QPalette SPTheme::popupPalette() const {
+    QPalette palette = palettes.value(current);
+    palette.setColor(QPalette::Window, themeColors.popup);
+    palette.setColor(QPalette::Base, themeColors.popup);
+    palette.setColor(QPalette::WindowText, themeColors.text);
+    return palette;
+}
+
+void SPTheme::usePopupPalette(QWidget* widget) {
+    widget->setPalette(instance().popupPalette());
+    connect(&instance(), &SPTheme::themeChanged, widget, [widget]() {
+        widget->setPalette(instance().popupPalette());
+    });
+}
+
+SPThemeColors SPTheme::colorsFor(const QString& name) {
+    if (name == "فاتح") {
+        return {
+            .background = QColor("#ffffff"),
+            .surface = QColor("#f0f1f5"),
+            .popup = QColor("#f7f7fa"),
+            .text = QColor("#333333"),
+            .brightText = QColor("#1e1e1e"),
+            .mutedText = QColor("#6e6e6e"),
+            .accent = QColor("#0a7fc2"),
+            .selection = QColor("#d4e6f5"),
+            .border = QColor("#c8cad6"),
+            .separator = QColor("#dcdee8"),
+            .separatorHover = QColor("#c0c3d4"),
+            .scrollHandle = QColor("#b9c7d6"),
+            .scrollHandleHover = QColor("#9fb2c7"),
+            .currentLine = QColor(230, 236, 248),
+            .lineNumber = QColor(110, 110, 110),
+            .diffRemovedLine = QColor(0xfd, 0xe4, 0xe4),
+            .diffAddedLine = QColor(0xdf, 0xf5, 0xe4),
+            .diffRemovedWord = QColor(0xf6, 0xb6, 0xba),
+            .diffAddedWord = QColor(0xa9, 0xe1, 0xb6),
+            .gitAdded = QColor(0x2e, 0x85, 0x40),
+            .gitModified = QColor(0x9a, 0x67, 0x00),
+            .gitDeleted = QColor(0xcf, 0x22, 0x2e),
+        };
+    }
+
+    return {
+        .background = QColor("#141520"),
+        .surface = QColor("#1e202e"),
+        .popup = QColor("#242533"),
+        .text = QColor("#cccccc"),
+        .brightText = QColor("#dddddd"),
+        .mutedText = QColor("#888888"),
+        .accent = QColor("#10a8f4"),
+        .selection = QColor("#3a3d54"),
+        .border = QColor("#303349"),
+        .separator = QColor("#2a2c44"),
+        .separatorHover = QColor("#393c5d"),
+        .scrollHandle = QColor("#254663"),
+        .scrollHandleHover = QColor("#325573"),
+        .currentLine = QColor(23, 24, 36, 240),
+        .lineNumber = QColor(200, 200, 200),
+        .diffRemovedLine = QColor(0x4b, 0x1f, 0x24),
+        .diffAddedLine = QColor(0x1f, 0x3b, 0x2a),
+        .diffRemovedWord = QColor(0x8c, 0x2f, 0x39),
+        .diffAddedWord = QColor(0x2e, 0x6b, 0x41),
+        .gitAdded = QColor(0x73, 0xc9, 0x91),
+        .gitModified = QColor(0xe2, 0xc0, 0x8d),
+        .gitDeleted = QColor(0xf1, 0x4c, 0x4c),
+    };
+}
+
+QPalette SPTheme::paletteFor(const SPThemeColors& colors) {
+    QPalette palette{};
+
+    palette.setColor(QPalette::Window, colors.surface);
+    palette.setColor(QPalette::WindowText, colors.brightText);
+    palette.setColor(QPalette::Base, colors.background);
+    palette.setColor(QPalette::AlternateBase, colors.surface);
+    palette.setColor(QPalette::Text, colors.text);
+    palette.setColor(QPalette::Button, colors.surface);
+    palette.setColor(QPalette::ButtonText, colors.brightText);
+    palette.setColor(QPalette::BrightText, colors.accent);
+    palette.setColor(QPalette::Highlight, colors.selection);
+    palette.setColor(QPalette::HighlightedText, colors.accent);
+    palette.setColor(QPalette::ToolTipBase, colors.popup);
+    palette.setColor(QPalette::ToolTipText, colors.text);
+    palette.setColor(QPalette::PlaceholderText, colors.mutedText);
+    palette.setColor(QPalette::Link, colors.accent);
+    palette.setColor(QPalette::LinkVisited, colors.accent);
+
+    palette.setColor(QPalette::Light, colors.separatorHover);
+    palette.setColor(QPalette::Midlight, colors.separator);
+    palette.setColor(QPalette::Mid, colors.border);
+    palette.setColor(QPalette::Dark, colors.separator);
+    palette.setColor(QPalette::Shadow, colors.background);
+
+    palette.setColor(QPalette::Disabled, QPalette::WindowText, colors.mutedText);
+    palette.setColor(QPalette::Disabled, QPalette::Text, colors.mutedText);
+    palette.setColor(QPalette::Disabled, QPalette::ButtonText, colors.mutedText);
+
+    return palette;
+}
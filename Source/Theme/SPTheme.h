@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QObject>
+#include <QColor>
+#include <QPalette>
+#include <QHash>
+#include <QStringList>
+
+
+// ألوان السمة، منها ما يذهب إلى لوحة الألوان ومنها ما يرسمه النمط أو المحرر مباشرة
+struct SPThemeColors {
+    QColor background{};        // خلفية المحرر والألواح
+    QColor surface{};           // النوافذ والقوائم وعناوين الألواح
+    QColor popup{};             // النوافذ المنبثقة
+    QColor text{};
+    QColor brightText{};
+    QColor mutedText{};
+    QColor accent{};
+    QColor selection{};
+    QColor border{};
+    QColor separator{};
+    QColor separatorHover{};
+    QColor scrollHandle{};
+    QColor scrollHandleHover{};
+    QColor currentLine{};
+    QColor lineNumber{};
+    QColor diffRemovedLine{};   // خلفية الأسطر في عرض الفروق
+    QColor diffAddedLine{};
+    QColor diffRemovedWord{};   // الكلمات المتغيرة داخل الأسطر
+    QColor diffAddedWord{};
+    QColor gitAdded{};          // علامات الهامش وأسماء الملفات في الشجرة
+    QColor gitModified{};
+    QColor gitDeleted{};
+};
+
+
+// محرك السمات: يضع لوحة ألوان محسوبة مسبقاً ونمطاً واحداً على كامل البرنامج بدل أوراق الأنماط
+// تغيير السمة يستبدل لوحة الألوان فقط، فتعاد رسم النوافذ دون إعادة تحليل أي ورقة أنماط
+class SPTheme : public QObject {
+    Q_OBJECT
+
+public:
+    static SPTheme& instance();
+    static QStringList themeNames();
+
+    // اسم غير معروف يرجع إلى السمة الافتراضية
+    void apply(const QString& name);
+    QString name() const { return current; }
+    const SPThemeColors& colors() const { return themeColors; }
+
+    // لوحة النوافذ المنبثقة، وتعاد على النافذة كلما تغيرت السمة
+    QPalette popupPalette() const;
+    static void usePopupPalette(QWidget* widget);
+
+    static constexpr const char* themeKey = "theme";
+
+signals:
+    void themeChanged();
+
+private:
+    SPTheme();
+
+    static SPThemeColors colorsFor(const QString& name);
+    static QPalette paletteFor(const SPThemeColors& colors);
+
+    QString current{};
+    SPThemeColors themeColors{};
+    QHash<QString, QPalette> palettes{};
+    bool styleInstalled{};
+};
@@ -1,4 +1,5 @@
 #include "Spectrum.h"
+#include "SPFileWatcher.h"
 
 #include <QDockWidget>
 #include <QVBoxLayout>
@@ -10,22 +11,17 @@
 #include <QCoreApplication>
 #include <QTextStream>
 #include <QApplication>
+#include <QStatusBar>
+#include <QTextBlock>
+#include <QDir>
+#include <QStringDecoder>
+#include <QtConcurrent/QtConcurrentRun>
 
 
 Spectrum::Spectrum(const QString& filePath, QWidget *parent)
     : QMainWindow(parent) {
     QScreen* screenSize = QGuiApplication::primaryScreen();
     this->setGeometry(screenSize->size().width() / 3, screenSize->size().height() / 7, 600, 700);
-    setStyleSheet(R"(
-            QMainWindow::separator {
-                background-color: #2a2c44;
-                width: 4px;
-                height: 4px;
-            }
-            
-            QMainWindow::separator:hover {
-                background-color: #393c5d;
-            })");
 
     QWidget* center = new QWidget(this);
     QVBoxLayout* vlay = new QVBoxLayout(center);
@@ -33,10 +29,18 @@ Spectrum::Spectrum(const QString& filePath, QWidget *parent)
     vlay->setSpacing(0);
 
     editor = new SPEditor(this);
+    SPStartupTrace::mark("إنشاء المحرر");
     //terminal = new Terminal(this);
-    //folderTree = new FolderTree(editor, this);
+    folderTree = new FolderTree(this);
+    projectIndex = new SPProjectIndex(this);
+    quickOpen = new SPQuickOpen(this);
+    searchPanel = new SPSearchPanel(this);
+    instrumentationPanel = new SPInstrumentationPanel(this);
+    projectReplace = new SPProjectReplace(this);
+    gitStatus = new SPGitStatus(this);
     menuBar = new SPMenuBar(this);
     setMenuBar(menuBar);
+    SPStartupTrace::mark("إنشاء الألواح والقوائم");
 
     updateWindowTitle();
 
@@ -45,9 +49,16 @@ Spectrum::Spectrum(const QString& filePath, QWidget *parent)
 
 
     //addDockWidget(Qt::BottomDockWidgetArea, terminal); // يجب أن تكون بعد vlay->addWidget(terminal)
-    //addDockWidget(Qt::RightDockWidgetArea, folderTree);
+    addDockWidget(Qt::RightDockWidgetArea, folderTree);
+    addDockWidget(Qt::BottomDockWidgetArea, searchPanel);
+    searchPanel->hide();
+    addDockWidget(Qt::LeftDockWidgetArea, instrumentationPanel);
+    instrumentationPanel->hide();
     this->setCentralWidget(center);
 
+    loadWatcher = new QFutureWatcher<SPFileLoad>(this);
+    connect(loadWatcher, &QFutureWatcher<SPFileLoad>::finished, this, &Spectrum::onFileLoaded);
+
     // لتشغيل ملف ألف بإستخدام محرر طيف عند إختيار المحرر ك برنامج للتشغيل
     if (!filePath.isEmpty()) {
         this->openFile(filePath);
@@ -57,8 +68,40 @@ Spectrum::Spectrum(const QString& filePath, QWidget *parent)
     QShortcut* saveShortcut = new QShortcut(QKeySequence::Save, this);
     connect(saveShortcut, &QShortcut::activated, this, &Spectrum::saveFile);
 
+    // Create a shortcut for Ctrl+P
+    QShortcut* quickOpenShortcut = new QShortcut(QKeySequence("Ctrl+P"), this);
+    connect(quickOpenShortcut, &QShortcut::activated, this, &Spectrum::openQuickOpen);
+
+    // Create a shortcut for Ctrl+Shift+F
+    QShortcut* searchShortcut = new QShortcut(QKeySequence("Ctrl+Shift+F"), this);
+    connect(searchShortcut, &QShortcut::activated, this, &Spectrum::openProjectSearch);
+
+    // Create a shortcut for Ctrl+Shift+H
+    QShortcut* frameHudShortcut = new QShortcut(QKeySequence("Ctrl+Shift+H"), this);
+    connect(frameHudShortcut, &QShortcut::activated, this, &Spectrum::toggleFrameHud);
+
     connect(menuBar, &SPMenuBar::newRequested, this, &Spectrum::newFile);
     connect(menuBar, &SPMenuBar::openRequested, this, [this](){this->openFile("");});
+    connect(menuBar, &SPMenuBar::openFolderRequested, folderTree, &FolderTree::openFolder);
+    connect(menuBar, &SPMenuBar::quickOpenRequested, this, &Spectrum::openQuickOpen);
+    connect(menuBar, &SPMenuBar::projectSearchRequested, this, &Spectrum::openProjectSearch);
+    connect(menuBar, &SPMenuBar::instrumentationRequested, this, [this]() {
+        instrumentationPanel->setVisible(!instrumentationPanel->isVisible());
+    });
+    connect(menuBar, &SPMenuBar::frameHudRequested, this, &Spectrum::toggleFrameHud);
+    connect(menuBar, &SPMenuBar::traceRequested, this, &Spectrum::toggleTrace);
+    SPMemory::trackDocument(editor->document(), [this]() {
+        return currentFilePath.isEmpty() ? QString("ملف جديد") : QFileInfo(currentFilePath).fileName();
+    });
+    SPMemory::registerReporter("فهرس المشروع", [this]() {
+        SPPathTablePtr table = projectIndex->snapshot();
+        return SPMemoryUsage{ table ? table->memoryUsage() : 0 };
+    }, this);
+    connect(&SPWatchdog::instance(), &SPWatchdog::stallDetected, this, [this](qint64, const QString& summary) {
+        statusBar()->showMessage(summary, 10000);
+    });
+    connect(menuBar, &SPMenuBar::compareSavedRequested, this, &Spectrum::compareWithSaved);
+    connect(menuBar, &SPMenuBar::compareFileRequested, this, &Spectrum::compareWithFile);
     connect(menuBar, &SPMenuBar::saveRequested, this, &Spectrum::saveFile);
     connect(menuBar, &SPMenuBar::saveAsRequested, this, &Spectrum::saveFileAs);
     connect(menuBar, &SPMenuBar::settingsRequest, this, &Spectrum::openSettings);
@@ -66,6 +109,65 @@ Spectrum::Spectrum(const QString& filePath, QWidget *parent)
     connect(menuBar, &SPMenuBar::runRequested, this, &Spectrum::runAlif);
     connect(menuBar, &SPMenuBar::aboutRequested, this, &Spectrum::aboutSpectrum);
     connect(editor, &SPEditor::openRequest, this, [this](QString filePath){this->openFile(filePath);});
+    connect(folderTree, &FolderTree::fileSelected, this, [this](QString filePath){this->openFile(filePath);});
+    connect(quickOpen, &SPQuickOpen::fileChosen, this, [this](QString filePath){this->openFile(filePath);});
+    connect(searchPanel, &SPSearchPanel::searchRequested, this, [this]() {
+        searchPanel->setSearchSource(projectIndex->snapshot(), openDocuments());
+    });
+    connect(searchPanel, &SPSearchPanel::matchActivated, this, &Spectrum::goToMatch);
+    connect(searchPanel, &SPSearchPanel::replaceRequested, this, &Spectrum::replaceInProject);
+    connect(projectReplace, &SPProjectReplace::finished, this, &Spectrum::onReplaceFinished);
+
+    // فهرسة ملفات المشروع في الخلفية عند تغيير المجلد
+    connect(folderTree, &FolderTree::folderChanged, projectIndex, &SPProjectIndex::setRootPath);
+    connect(projectIndex, &SPProjectIndex::progress, this, [this](int filesFound) {
+        statusBar()->showMessage(QString("جاري فهرسة المشروع: %1 ملف").arg(filesFound));
+    });
+    connect(projectIndex, &SPProjectIndex::watchLimitReached, this, [this](int polledDirs) {
+        statusBar()->showMessage(QString("نفد حد مراقبة الملفات في النظام، %1 مجلد يحدث كل %2 ثوان")
+                                     .arg(polledDirs).arg(SPFileWatcher::pollIntervalMs / 1000), 10000);
+    });
+    connect(projectIndex, &SPProjectIndex::ready, this, [this](int fileCount, qint64 elapsedMs) {
+        folderTree->setTable(projectIndex->snapshot());
+        statusBar()->showMessage(QString("تمت فهرسة %1 ملف خلال %2 مللي ثانية").arg(fileCount).arg(elapsedMs), 5000);
+    });
+    // الفهرس يتحدث تلقائياً من أحداث نظام الملفات، والفتح السريع يعرض اللقطة الجديدة إن كان ظاهراً
+    connect(projectIndex, &SPProjectIndex::changed, this, [this](const SPIndexDelta& delta) {
+        // الذاكرة المؤقتة تتحقق من وقت التعديل عند كل قراءة، وإخراج الملفات المتغيرة هنا يحرر ذاكرتها فقط
+        QString root = projectIndex->rootPath();
+        for (const QString& path : delta.removedFiles + delta.modifiedFiles) {
+            SPFileCache::instance().invalidate(root + '/' + path);
+        }
+        folderTree->setTable(projectIndex->snapshot());
+        quickOpen->refresh(projectIndex->snapshot());
+        gitStatus->scheduleRefresh();
+    });
+
+    // حالة git تحسب خارج الخيط الرئيسي وتصل للشجرة والهامش عند جاهزيتها
+    connect(folderTree, &FolderTree::folderChanged, gitStatus, &SPGitStatus::setRootPath);
+    connect(gitStatus, &SPGitStatus::statusChanged, this, [this]() {
+        folderTree->setGitStates(gitStatus->states());
+        requestGutterDiff();
+    });
+    connect(gitStatus, &SPGitStatus::lineDiffReady, this, [this](const QString& path, const QList<SPLineMarker>& markers) {
+        if (!currentFilePath.isEmpty() and path == QFileInfo(currentFilePath).absoluteFilePath()) {
+            editor->setLineMarkers(markers);
+        }
+    });
+    gutterDiffTimer = new QTimer(this);
+    gutterDiffTimer->setSingleShot(true);
+    gutterDiffTimer->setInterval(500);
+    connect(gutterDiffTimer, &QTimer::timeout, this, &Spectrum::requestGutterDiff);
+    connect(editor->document(), &QTextDocument::contentsChanged, gutterDiffTimer, qOverload<>(&QTimer::start));
+
+    // المكونات المؤجلة تبنى بعد أول رسم للمحرر لكي تظهر بدون تأخير عند أول استخدام
+    idleTasks = {
+        [this]() { editor->warmUp(); },
+        []() { SPFontFamilyModel::instance()->load(); },
+        [this]() { ensureSettings(); },
+        [this]() { ensureDiffView(); },
+    };
+    editor->viewport()->installEventFilter(this);
 
     // Connect modification signal so when doc modified it's add "*"
     connect(editor->document(), &QTextDocument::modificationChanged,
@@ -73,16 +175,30 @@ Spectrum::Spectrum(const QString& filePath, QWidget *parent)
 }
 
 Spectrum::~Spectrum() {
-    QSettings settings("Alif", "Spectrum");
-    settings.setValue("editorFontSize", editor->font().pointSize());
-
     delete editor;
     delete menuBar;
 }
 
+// أول رسم لمساحة المحرر يبدأ تنفيذ المهام المؤجلة
+bool Spectrum::eventFilter(QObject* watched, QEvent* event) {
+    if (watched == editor->viewport() and event->type() == QEvent::Paint) {
+        editor->viewport()->removeEventFilter(this);
+        QTimer::singleShot(0, this, &Spectrum::runIdleTask);
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void Spectrum::runIdleTask() {
+    if (idleTasks.isEmpty()) return;
+    idleTasks.takeFirst()();
+    if (!idleTasks.isEmpty()) {
+        QTimer::singleShot(0, this, &Spectrum::runIdleTask);
+    }
+}
+
 // الكتابة فوق دالة إغلاق البرنامج الرئيسية
 void Spectrum::closeEvent(QCloseEvent *event) {
-    int isNeedSave = needSave();
+    int isNeedSave = exitConfirmed ? 2 : needSave();
     if (!isNeedSave) {
         event->ignore();
         return;
@@ -93,10 +209,29 @@ void Spectrum::closeEvent(QCloseEvent *event) {
         return;
     }
 
-    QApplication::quit();
+    // البرنامج ينتهي عند إغلاق آخر نافذة
     event->accept();
 }
 
+void Spectrum::changeEvent(QEvent* event) {
+    // مراقب التجمد يصف مستند النافذة التي يعمل فيها المستخدم
+    if (event->type() == QEvent::ActivationChange and isActiveWindow()) {
+        lastActive = this;
+        SPWatchdog::instance().setDocument(editor->document());
+    }
+    QMainWindow::changeEvent(event);
+}
+
+Spectrum* Spectrum::activeInstance() {
+    if (lastActive and lastActive->isVisible()) return lastActive;
+
+    for (QWidget* widget : QApplication::topLevelWidgets()) {
+        Spectrum* window = qobject_cast<Spectrum*>(widget);
+        if (window and window->isVisible()) return window;
+    }
+    return nullptr;
+}
+
 
 /* ----------------------------------- File Menu Button ----------------------------------- */
 
@@ -147,28 +282,211 @@ void Spectrum::openFile(QString filePath) {
         filePath = QFileDialog::getOpenFileName(nullptr, "فتح ملف", "", "ملف ألف (*.alif *.aliflib);;All Files (*)");
     }
     if (!filePath.isEmpty()) {
-        QFile file(filePath);
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream in(&file);
-            QString content = in.readAll();
-            editor->document()->setPlainText(content);
-            file.close();
-            currentFilePath = filePath;
-            editor->document()->setModified(false);
-            updateWindowTitle();
+        loadFile(filePath);
+    }
+}
 
-            // حل مؤقت لارجاع المؤشرة الى بداية الملف حيث أنه يجب أن تظهر في البداية بشكل إفتراضي
-            QTextCursor cursor = editor->textCursor();
-            cursor.setPosition(0);
-            editor->setTextCursor(cursor);
+void Spectrum::loadFile(const QString& filePath) {
+    // تتم قراءة الملف في خيط خلفي حتى لا تتجمد الواجهة أثناء قراءة الملفات الكبيرة
+    // تعيين مستقبل جديد يلغي انتظار نتيجة أي تحميل سابق لم ينتهِ
+    QFuture<SPFileLoad> future = QtConcurrent::run([filePath]() {
+        SP_TRACE_SCOPE("openFile.read");
+        SPFileLoad load{filePath};
+        if (SPFileBufferPtr buffer = SPFileCache::instance().read(filePath)) {
+            QStringDecoder decoder(QStringDecoder::Utf8);
+            load.content = decoder(buffer->view());
+            load.content.replace("\r\n", "\n");
+            load.ok = true;
         }
-        else {
-            QMessageBox::warning(nullptr, "خطأ", "لا يمكن فتح الملف");
+        return load;
+    });
+    loadWatcher->setFuture(future);
+    loading = true;
+    // المحتوى المقروء يستبدل المستند كاملاً، فالكتابة أثناء التحميل تضيع دون سؤال عن حفظها
+    updateReadOnly();
+}
+
+void Spectrum::onFileLoaded() {
+    SP_TRACE_SCOPE("openFile.apply");
+    loading = false;
+    updateReadOnly();
+    SPFileLoad load = loadWatcher->result();
+    if (!load.ok) {
+        QMessageBox::warning(nullptr, "خطأ", "لا يمكن فتح الملف");
+        return;
+    }
+
+    editor->document()->setPlainText(load.content);
+    currentFilePath = load.path;
+    editor->document()->setModified(false);
+    updateWindowTitle();
+
+    // حل مؤقت لارجاع المؤشرة الى بداية الملف حيث أنه يجب أن تظهر في البداية بشكل إفتراضي
+    QTextCursor cursor = editor->textCursor();
+    cursor.setPosition(0);
+    editor->setTextCursor(cursor);
+
+    if (folderTree->rootPath().isEmpty()) {
+        folderTree->setRootPath(QFileInfo(load.path).absolutePath());
+    }
+
+    if (pendingJump.path == load.path) {
+        selectRange(pendingJump.line, pendingJump.column, pendingJump.length);
+    }
+    pendingJump = {};
+}
+
+void Spectrum::updateReadOnly() {
+    editor->setReadOnly(loading or projectReplace->isRunning());
+}
+
+void Spectrum::openExternalFiles(const QStringList& files) {
+    // النافذة الفارغة تستخدم للملف الأول، والتحميل غير متزامن لذلك يتحقق منه قبل البدء
+    bool reuse = isVisible() and currentFilePath.isEmpty() and !editor->document()->isModified()
+                 and !loadWatcher->isRunning();
+    bool activate = files.isEmpty() or reuse;
+
+    for (const QString& path : files) {
+        if (reuse) {
+            loadFile(path);
+            reuse = false;
+            continue;
+        }
+        Spectrum* window = new Spectrum(path);
+        window->setAttribute(Qt::WA_DeleteOnClose);
+        window->showMaximized();
+    }
+
+    if (activate) {
+        setWindowState((windowState() & ~Qt::WindowMinimized) | Qt::WindowActive);
+        raise();
+        activateWindow();
+    }
+}
+
+void Spectrum::openQuickOpen() {
+    SPPathTablePtr table = projectIndex->snapshot();
+    if (!table) {
+        if (projectIndex->rootPath().isEmpty()) {
+            // لا يوجد مشروع مفتوح، لذلك يتم استخدام نافذة الفتح العادية
+            this->openFile("");
+        } else {
+            statusBar()->showMessage("فهرسة المشروع لم تنتهِ بعد", 3000);
         }
+        return;
     }
+
+    quickOpen->popup(table);
+}
+
+void Spectrum::openProjectSearch() {
+    searchPanel->focusInput();
+}
+
+void Spectrum::goToMatch(const QString& filePath, int line, int column, int length) {
+    if (QFileInfo(filePath) == QFileInfo(currentFilePath)) {
+        selectRange(line, column, length);
+        return;
+    }
+
+    pendingJump = { filePath, line, column, length };
+    this->openFile(filePath);
+}
+
+void Spectrum::selectRange(int line, int column, int length) {
+    QTextBlock block = editor->document()->findBlockByNumber(line);
+    if (!block.isValid()) return;
+
+    QTextCursor cursor(block);
+    cursor.setPosition(block.position() + qMin(column, block.length() - 1));
+    cursor.setPosition(qMin(cursor.position() + length, block.position() + block.length() - 1), QTextCursor::KeepAnchor);
+    editor->setTextCursor(cursor);
+    editor->centerCursor();
+    editor->setFocus();
+}
+
+void Spectrum::replaceInProject(const SPSearchQuery& query, const QString& replacement,
+                                const QList<SPFileMatches>& selected) {
+    SPReplaceResult failed{};
+    SPReplacePlan plan{};
+    if (projectReplace->isRunning()) return;
+    if (!plan.prepare(query, replacement)) {
+        failed.error = "التعبير النمطي غير صالح";
+        searchPanel->replaceFinished(failed);
+        return;
+    }
+
+    int matchCount = 0;
+    for (const SPFileMatches& file : selected) {
+        matchCount += int(file.matches.size());
+    }
+    int answer = QMessageBox::question(this, "استبدال في المشروع",
+                                       QString("سيتم استبدال %1 تطابق في %2 ملف. هل تريد المتابعة؟")
+                                           .arg(matchCount).arg(selected.size()));
+    if (answer != QMessageBox::Yes) {
+        failed.error = "تم الإلغاء";
+        searchPanel->replaceFinished(failed);
+        return;
+    }
+
+    // المستند المفتوح يعدل في الذاكرة، وبقية الملفات تكتب على القرص
+    QString openPath = openDocuments().keys().value(0);
+    QList<SPFileMatches> closedFiles{};
+    pendingDocumentEdits.clear();
+    for (const SPFileMatches& file : selected) {
+        if (file.filePath != openPath) {
+            closedFiles.append(file);
+            continue;
+        }
+        if (!plan.computeEdits(editor->document()->toPlainText(), file.matches, pendingDocumentEdits)) {
+            pendingDocumentEdits.clear();
+            failed.error = "تغير المستند المفتوح منذ البحث، أعد البحث";
+            searchPanel->replaceFinished(failed);
+            return;
+        }
+    }
+
+    // المحرر للقراءة فقط حتى تنتهي العملية لكي تبقى مواضع التعديلات صحيحة
+    projectReplace->start(closedFiles, plan);
+    updateReadOnly();
+}
+
+void Spectrum::onReplaceFinished(const SPReplaceResult& result) {
+    updateReadOnly();
+
+    SPReplaceResult total = result;
+    if (result.ok and !pendingDocumentEdits.isEmpty()) {
+        // خطوة تراجع واحدة للمستند كاملاً، والتعديلات تطبق من الآخر لكي لا تتغير المواضع السابقة
+        QTextCursor cursor(editor->document());
+        cursor.beginEditBlock();
+        for (qsizetype i = pendingDocumentEdits.size() - 1; i >= 0; --i) {
+            const SPReplaceEdit& edit = pendingDocumentEdits.at(i);
+            cursor.setPosition(int(edit.offset));
+            cursor.setPosition(int(edit.offset + edit.length), QTextCursor::KeepAnchor);
+            cursor.insertText(edit.replacement);
+        }
+        cursor.endEditBlock();
+
+        total.filesChanged += 1;
+        total.replacements += int(pendingDocumentEdits.size());
+    }
+    pendingDocumentEdits.clear();
+
+    searchPanel->replaceFinished(total);
+}
+
+QHash<QString, QString> Spectrum::openDocuments() const {
+    // البحث يستخدم النص الموجود في المحرر بدلاً من الملف المحفوظ
+    QHash<QString, QString> documents{};
+    if (!currentFilePath.isEmpty()) {
+        documents.insert(QDir::cleanPath(QFileInfo(currentFilePath).absoluteFilePath()),
+                         editor->document()->toPlainText());
+    }
+    return documents;
 }
 
 void Spectrum::saveFile() {
+    SP_TRACE_SCOPE("saveFile");
     QString content = editor->document()->toPlainText();
     if (currentFilePath.isEmpty()) {
         saveFileAs();
@@ -181,6 +499,7 @@ void Spectrum::saveFile() {
             file.close();
             editor->document()->setModified(false);
             updateWindowTitle();
+            gitStatus->scheduleRefresh();
         }
         else {
             QMessageBox::warning(nullptr, "خطأ", "لا يمكن حفظ الملف");
@@ -210,13 +529,23 @@ void Spectrum::saveFileAs() {
 
 
 void Spectrum::openSettings() {
-    // Prevent multiple settings windows
-    if (settings and settings->isVisible()) return;
+    ensureSettings();
+    settings->show();
+    settings->raise();
+    settings->activateWindow();
+}
 
+// نافذة الإعدادات تبنى مرة واحدة وتخفى عند إغلاقها، لأن بناءها يقرأ قائمة الخطوط كاملة
+void Spectrum::ensureSettings() {
+    if (settings) return;
     settings = new SPSettings(this);
-    connect(settings, &SPSettings::fontSizeChanged, editor, &SPEditor::updateFontSize);
+}
 
-    settings->show();
+void Spectrum::ensureDiffView() {
+    if (diffView) return;
+    diffView = new SPDiffView(this);
+    addDockWidget(Qt::BottomDockWidgetArea, diffView);
+    diffView->hide();
 }
 
 
@@ -230,7 +559,11 @@ void Spectrum::exitApp() {
         return;
     }
 
-    QApplication::quit();
+    // كل نافذة تسأل عن حفظ ملفها عند إغلاقها، وهذه النافذة سألت للتو
+    // والمستند يبقى معدلاً، فإن ألغي الخروج من نافذة أخرى لا يضيع أن فيه تغييرات غير محفوظة
+    exitConfirmed = true;
+    QApplication::closeAllWindows();
+    exitConfirmed = false;
 }
 
 
@@ -351,6 +684,64 @@ void Spectrum::onModificationChanged(bool modified) {
     this->setWindowModified(modified);
 }
 
+void Spectrum::toggleFrameHud() {
+    editor->setFrameHudVisible(!editor->isFrameHudVisible());
+}
+
+void Spectrum::toggleTrace() {
+    if (!SPTrace::isEnabled()) {
+        SPTrace::clear();
+        SPTrace::setEnabled(true);
+        statusBar()->showMessage("بدأ تسجيل التتبع، اختر الأمر مرة أخرى لحفظه");
+        return;
+    }
+
+    SPTrace::setEnabled(false);
+    statusBar()->clearMessage();
+    QString path = QFileDialog::getSaveFileName(nullptr, "حفظ التتبع", "spectrum-trace.json", "Chrome trace (*.json)");
+    if (path.isEmpty()) return;
+    if (SPTrace::write(path)) {
+        statusBar()->showMessage(QString("حفظ %1 حدث في %2").arg(SPTrace::eventCount()).arg(path), 5000);
+    }
+    else {
+        QMessageBox::warning(nullptr, "خطأ", "لا يمكن حفظ ملف التتبع");
+    }
+}
+
+void Spectrum::compareWithSaved() {
+    if (currentFilePath.isEmpty()) {
+        statusBar()->showMessage("الملف غير محفوظ بعد", 3000);
+        return;
+    }
+
+    QString name = QFileInfo(currentFilePath).fileName();
+    ensureDiffView();
+    diffView->compareFile(currentFilePath, name + " (المحفوظ)", name + " (المحرر)", editor->document()->toPlainText());
+    diffView->show();
+    diffView->raise();
+}
+
+void Spectrum::compareWithFile() {
+    QString startDir = currentFilePath.isEmpty() ? folderTree->rootPath() : QFileInfo(currentFilePath).absolutePath();
+    QString path = QFileDialog::getOpenFileName(nullptr, "مقارنة مع ملف", startDir, "All Files (*)");
+    if (path.isEmpty()) return;
+
+    QString name = currentFilePath.isEmpty() ? QString("ملف جديد") : QFileInfo(currentFilePath).fileName();
+    ensureDiffView();
+    diffView->compareFile(path, QFileInfo(path).fileName(), name + " (المحرر)", editor->document()->toPlainText());
+    diffView->show();
+    diffView->raise();
+}
+
+void Spectrum::requestGutterDiff() {
+    gutterDiffTimer->stop();
+    if (currentFilePath.isEmpty()) {
+        editor->setLineMarkers({});
+        return;
+    }
+    gitStatus->requestLineDiff(QFileInfo(currentFilePath).absoluteFilePath(), editor->document()->toPlainText());
+}
+
 
 
 
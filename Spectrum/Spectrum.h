@@ -1,12 +1,35 @@
 #pragma once
 
-//#include "SPFolders.h"
+#include "SPFolders.h"
 #include "SPEditor.h"
 //#include "SPTerminal.h"
 #include "SPMenu.h"
 #include "SPSettings.h"
+#include "SPProjectIndex.h"
+#include "SPQuickOpen.h"
+#include "SPSearchPanel.h"
+#include "SPFileCache.h"
+#include "SPInstrumentationPanel.h"
+#include "SPStartupTrace.h"
+#include "SPTrace.h"
+#include "SPWatchdog.h"
+#include "SPMemory.h"
+#include "SPGitStatus.h"
+#include "SPDiffView.h"
 
 #include <QMainWindow>
+#include <QFutureWatcher>
+#include <QPointer>
+
+#include <functional>
+
+
+// نتيجة قراءة ملف في الخلفية
+struct SPFileLoad {
+    QString path{};
+    QString content{};
+    bool ok{};
+};
 
 
 class Spectrum : public QMainWindow
@@ -17,12 +40,27 @@ public:
     Spectrum(const QString& filePath = "", QWidget* parent = nullptr);
     ~Spectrum();
 
+    // آخر نافذة ظاهرة نشطها المستخدم، أو أي نافذة ظاهرة إن لم تنشط واحدة بعد
+    static Spectrum* activeInstance();
+
+public slots:
+    // ملفات من تشغيل آخر للمحرر: الأول في هذه النافذة إن كانت فارغة والباقي في نوافذ جديدة
+    void openExternalFiles(const QStringList& files);
+
 protected:
     void closeEvent(QCloseEvent *event) override;
+    void changeEvent(QEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private slots:
     void newFile();
     void openFile(QString);
+    void onFileLoaded();
+    void openQuickOpen();
+    void openProjectSearch();
+    void goToMatch(const QString& filePath, int line, int column, int length);
+    void replaceInProject(const SPSearchQuery& query, const QString& replacement, const QList<SPFileMatches>& selected);
+    void onReplaceFinished(const SPReplaceResult& result);
     void saveFile();
     void saveFileAs();
     void openSettings();
@@ -33,15 +71,60 @@ private slots:
 
     void updateWindowTitle();
     void onModificationChanged(bool modified);
+    void requestGutterDiff();
+    void compareWithSaved();
+    void compareWithFile();
+    void toggleFrameHud();
+    // أول ضغطة تبدأ التسجيل والثانية توقفه وتحفظه
+    void toggleTrace();
 
 private:
     int needSave();
+    void loadFile(const QString& filePath);
+    // المحرر للقراءة فقط أثناء تحميل ملف أو استبدال في المشروع
+    void updateReadOnly();
+    void ensureSettings();
+    void ensureDiffView();
+    void runIdleTask();
+    void selectRange(int line, int column, int length);
+    QHash<QString, QString> openDocuments() const;
 
 private:
     SPEditor* editor{};
     SPMenuBar* menuBar{};
     SPSettings* settings{};
+    FolderTree* folderTree{};
+    SPProjectIndex* projectIndex{};
+    SPQuickOpen* quickOpen{};
+    SPSearchPanel* searchPanel{};
+    SPInstrumentationPanel* instrumentationPanel{};
+    SPProjectReplace* projectReplace{};
+    SPGitStatus* gitStatus{};
+    SPDiffView* diffView{};
+    // فروق الهامش تحسب بعد توقف الكتابة قليلاً وليس مع كل حرف
+    QTimer* gutterDiffTimer{};
+
+    QFutureWatcher<SPFileLoad>* loadWatcher{};
+    // من بدء القراءة حتى تطبيق نتيجتها، وليس فقط أثناء عمل الخيط الخلفي
+    bool loading{};
 
     QString currentFilePath{};
+    // أكد المستخدم الخروج من هذه النافذة، فلا يسأل مرة ثانية عند إغلاقها مع بقية النوافذ
+    bool exitConfirmed{};
+
+    // موضع ينتقل إليه المؤشر بعد انتهاء تحميل الملف
+    struct PendingJump {
+        QString path{};
+        int line{ -1 };
+        int column{};
+        int length{};
+    } pendingJump{};
+
+    // مكونات غير ضرورية للرسم الأول، تبنى بعده واحداً في كل دورة أحداث
+    QList<std::function<void()>> idleTasks{};
+
+    // تعديلات المستند المفتوح، تطبق فقط بعد نجاح الكتابة على القرص
+    QList<SPReplaceEdit> pendingDocumentEdits{};
 
+    static inline QPointer<Spectrum> lastActive{};
 };
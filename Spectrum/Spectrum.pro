@@ -1,4 +1,4 @@
-QT += core gui
+QT += core gui concurrent network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -15,32 +15,15 @@ RESOURCES += \
     resources.qrc
 
 
-# Include directories
-INCLUDEPATH +=  ../Source/TextEditor \
-                ../Source/MenuBar   \
-                ../Source/Settings  \
-                ../source/Components    \
+# ملفات المحرر في قائمة مشتركة مع أدوات القياس
+include(../Source/Source.pri)
 
 SOURCES += \
     Spectrum.cpp \
     main.cpp     \
-    ../Source/TextEditor/AlifComplete.cpp \
-    ../Source/TextEditor/AlifLexer.cpp \
-    ../Source/TextEditor/SPEditor.cpp \
-    ../Source/TextEditor/SPHighlighter.cpp \
-    ../Source/MenuBar/SPMenu.cpp    \
-    ../Source/Settings/SPSettings.cpp   \
-    ../Source/Components/FlatButton.cpp \
 
 HEADERS += \
     Spectrum.h  \
-    ../Source/TextEditor/AlifComplete.h \
-    ../Source/TextEditor/AlifLexer.h \
-    ../Source/TextEditor/SPEditor.h \
-    ../Source/TextEditor/SPHighlighter.h \
-    ../Source/MenuBar/SPMenu.h  \
-    ../Source/Settings/SPSettings.h \
-    ../Source/Components/FlatButton.h \
 
 
 
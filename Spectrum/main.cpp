@@ -1,102 +1,139 @@
 #include "Spectrum.h"
+#include "SPFileCache.h"
+#include "SPFileWatcher.h"
+#include "SPInstrumentation.h"
+#include "SPStartupTrace.h"
+#include "SPTrace.h"
+#include "SPWatchdog.h"
+#include "SPMemory.h"
+#include "SPSingleInstance.h"
+#include "SPTheme.h"
+#include "SPFonts.h"
+#include "SPLayoutCache.h"
 
 #include <QApplication>
-#include <QMessageBox>
 #include <QDebug>
 
 int main(int argc, char *argv[])
 {
+    SPStartupTrace::start();
+    // ملف الإعدادات يقرأ في الخلفية أثناء تهيئة البرنامج
+    SPConfig::instance();
+
     QApplication app(argc, argv);
     QCoreApplication::setOrganizationName("Alif");
     QCoreApplication::setApplicationName("Spectrum");
     app.setLayoutDirection(Qt::RightToLeft);
+    SPStartupTrace::mark("تهيئة QApplication");
 
-    int fontId1 = QFontDatabase::addApplicationFont(":/fonts/Resources/fonts/Tajawal/Tajawal-Regular.ttf");
-    int fontId2 = QFontDatabase::addApplicationFont(":/fonts/Resources/fonts/KawkabMono-Regular.ttf");
-    if(fontId1 == -1 or fontId2 == -1) {
+    // لتشغيل ملف ألف بإستخدام محرر طيف عند إختيار المحرر ك برنامج للتشغيل
+    QStringList arguments = app.arguments();
+    SPStartupTrace::configure(arguments);
+    SPTrace::configure(arguments);
+    bool newInstance = arguments.removeAll("--new-instance") > 0 or SPStartupTrace::isActive()
+                       or SPTrace::isEnabled();
+    QStringList files = arguments.mid(1);
+
+    // إن كانت هناك نسخة عاملة تفتح الملفات فيها ويخرج هذا التشغيل قبل تحميل أي شيء، حتى الخطوط
+    SPSingleInstance instance{};
+    if (!newInstance and instance.sendToRunning(files)) return 0;
+
+    // تسجيل الخطوط يجري في الخلفية أثناء بدء الاستماع للتشغيلات اللاحقة
+    SPFonts::registerInBackground();
+    if (!newInstance) instance.listen();
+
+    QStringList fontFamilies = SPFonts::families();
+    if(fontFamilies.isEmpty()) {
         qWarning() << "لم يستطع تحميل الخط";
     } else {
-        QString tajawal = QFontDatabase::applicationFontFamilies(fontId1).at(0);
-        QString kawkabMono = QFontDatabase::applicationFontFamilies(fontId2).at(0);
         QFont font{};
-        QStringList fontFamilies{};
-        fontFamilies << tajawal << kawkabMono;
         font.setFamilies(fontFamilies);
         font.setPixelSize(16);
         font.setWeight(QFont::Weight::Thin);
         app.setFont(font);
     }
-
-    // تخصيص شريط التمرير العمودي في كامل المحرر
-    app.setStyleSheet(R"(
-        QScrollBar:vertical {
-            background: transparent;
-            width: 20px;
-            margin: 18px 6px 18px 6px;
-        }
-
-        QScrollBar::handle:vertical {
-            background: #254663;
-            min-height: 15px;
-            border-radius: 4px;
-        }
-
-        QScrollBar::handle:vertical:hover {
-            background: #325573;
-        }
-
-        QScrollBar::add-line:vertical { /* المكان الذي يحمل السهم السفلي */
-            background: transparent;
-            height: 16px;
-            padding: 2px;
-            subcontrol-position: bottom;
-            subcontrol-origin: margin;
-        }
-
-        QScrollBar::sub-line:vertical { /* المكان الذي يحمل السهم العلوي*/
-            background: transparent;
-            height: 16px;
-            padding: 2px;
-            subcontrol-position: top;
-            subcontrol-origin: margin;
-        }
-
-        QScrollBar::up-arrow:vertical,
-        QScrollBar::down-arrow:vertical {
-            width: 12px;
-            background: none;
-            color: white;
-        }
-
-        QScrollBar::up-arrow:vertical {
-            image: url(:/icons/Resources/up-arrow.png);
-        }
-
-        QScrollBar::down-arrow:vertical {
-            image: url(:/icons/Resources/down-arrow.png);
-        }
-
-        QScrollBar::add-page:vertical,
-        QScrollBar::sub-page:vertical {
-            background: none;
-        }
-    )");
-
-
-
-    // لتشغيل ملف ألف بإستخدام محرر طيف عند إختيار المحرر ك برنامج للتشغيل
-    QString filePath{};
-    if (app.arguments().count() > 2) {
-        int ret = QMessageBox::warning(nullptr, "ألف",
-                                       "لا يمكن تمرير أكثر من معامل واحد",
-                                       QMessageBox::Close);
-        return ret;
-    }
-    if (app.arguments().count() == 2) {
-        filePath = app.arguments().at(1);
-    }
-
-    Spectrum w(filePath);
+    SPStartupTrace::mark("تحميل الخطوط");
+
+    // الألوان تأتي من لوحة ألوان محسوبة مسبقاً، والعناصر الخاصة مثل شريط التمرير يرسمها نمط البرنامج
+    SPTheme::instance().apply(SPConfig::instance().value(SPTheme::themeKey).toString());
+    SPStartupTrace::mark("السمة");
+
+
+    // قياسات الخدمات المشتركة تظهر في لوحة الأداء
+    SPInstrumentation::registerProvider("ذاكرة الملفات المؤقتة", []() {
+        SPFileCache::Stats stats = SPFileCache::instance().stats();
+        return QList<SPMetric>{
+            { "نسبة الإصابة", SPInstrumentation::formatPercent(stats.hits, stats.hits + stats.misses) },
+            { "إصابات / إخفاقات", QString("%1 / %2").arg(stats.hits).arg(stats.misses) },
+            { "بايتات لم تقرأ من القرص", SPInstrumentation::formatBytes(stats.bytesSaved) },
+            { "المستخدم / الميزانية", SPInstrumentation::formatBytes(stats.bytesUsed) + " / "
+                                      + SPInstrumentation::formatBytes(stats.budget) },
+            { "عدد الملفات", QString::number(stats.entries) },
+            { "مرات الإخراج", QString::number(stats.evictions) },
+        };
+    });
+    SPInstrumentation::registerProvider("تخطيط الأسطر", []() {
+        SPLayoutCache::Stats stats = SPLayoutCache::instance().stats();
+        quint64 shaped = qMax<quint64>(stats.misses, 1);
+        return QList<SPMetric>{
+            { "نسبة الإصابة", SPInstrumentation::formatPercent(stats.hits, stats.hits + stats.misses) },
+            { "إصابات / تشكيل", QString("%1 / %2").arg(stats.hits).arg(stats.misses) },
+            { "زمن التشكيل الكلي", QString("%1 مللي ثانية").arg(stats.shapingNs / 1e6, 0, 'f', 1) },
+            { "متوسط تشكيل السطر", QString("%1 ميكروثانية").arg(stats.shapingNs / 1e3 / shaped, 0, 'f', 1) },
+            { "الأسطر المحفوظة", QString::number(stats.lines) },
+            { "الأحرف / الميزانية", QString("%1 / %2").arg(stats.chars).arg(stats.budget) },
+            { "مرات الإخراج", QString::number(stats.evictions) },
+        };
+    });
+    SPInstrumentation::registerProvider("مراقبة الملفات", []() {
+        return QList<SPMetric>{
+            { "مجلدات تفحص دورياً", QString::number(SPFileWatcher::polledDirCount()) },
+        };
+    });
+    SPInstrumentation::registerProvider("بدء التشغيل", &SPStartupTrace::metrics);
+    SPInstrumentation::registerProvider("التتبع", []() {
+        return QList<SPMetric>{
+            { "الحالة", SPTrace::isEnabled() ? "يسجل" : "متوقف" },
+            { "الأحداث المحفوظة", QString::number(SPTrace::eventCount()) },
+        };
+    });
+    SPInstrumentation::registerProvider("تجمد الواجهة", []() {
+        return SPWatchdog::instance().metrics();
+    });
+
+    // ذاكرة الخدمات المشتركة، والمستندات وفهرس المشروع تسجلها كل نافذة
+    SPMemory::registerReporter("ذاكرة الملفات المؤقتة", []() {
+        SPFileCache::Stats stats = SPFileCache::instance().stats();
+        return SPMemoryUsage{ stats.bytesUsed, stats.budget };
+    });
+    SPMemory::registerReporter("أشكال حروف الأسطر", []() {
+        SPLayoutCache::Stats stats = SPLayoutCache::instance().stats();
+        return SPMemoryUsage{ stats.chars * SPMemory::bytesPerShapedChar, stats.budget * SPMemory::bytesPerShapedChar };
+    });
+    SPMemory::registerReporter("جداول الإكمال", []() {
+        return SPMemoryUsage{ AutoComplete::memoryUsage() };
+    });
+    SPMemory::registerReporter("حلقات التتبع", []() {
+        return SPMemoryUsage{ SPTrace::memoryUsage() };
+    });
+    SPInstrumentation::registerProvider("الذاكرة", &SPMemory::metrics);
+
+    Spectrum w(files.value(0));
+    w.openExternalFiles(files.mid(1));
+    // الملفات تفتح في النافذة التي يعمل فيها المستخدم وليس دائماً في الأولى
+    QObject::connect(&instance, &SPSingleInstance::filesReceived, &w, [&w](const QStringList& files) {
+        Spectrum* target = Spectrum::activeInstance();
+        (target ? target : &w)->openExternalFiles(files);
+    });
+    SPStartupTrace::mark("إكمال النافذة");
+    SPStartupTrace::watchFirstPaint(&w);
     w.showMaximized();
+    SPStartupTrace::mark("عرض النافذة");
+    // المراقب يبدأ بعد عرض النافذة حتى لا يعد بدء التشغيل تجمداً
+    SPWatchdog::instance().start();
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, []() {
+        SPWatchdog::instance().stop();
+        SPConfig::instance().flush();
+    });
     return app.exec();
 }